@@ -0,0 +1,36 @@
+/* OpenCL 1.2 --- core/filter.cl                                    INTERFACE */
+
+/** @file include/core/filter.cl
+  *
+  * @brief Kernel Denoising Filter
+  *
+  * This unit implements an edge-avoiding a-trous wavelet filter (Dammertz et
+  * al., 2010), which smooths the noise out of the frame buffer at low sample
+  * counts while preserving geometric edges, detected through the per-pixel
+  * normal and depth features stored by the render kernel.
+  *
+  * The filter is run for a few passes, each of which has a sparse 5x5 kernel
+  * with twice the step size of the previous one, which makes its cost small
+  * compared to rendering even a single sample.
+**/
+
+#pragma once
+
+#include <core/frame_io.cl>
+
+/** Runs a single pass of the filter for this work item.
+  *
+  * @param frm_info  The frame information structure.
+  * @param ftr_data  The feature buffer.
+  * @param src       The input, in the frame buffer format.
+  * @param dst       The output, in the frame buffer format.
+  * @param step      The step size, which should be doubled after each pass.
+  *
+  * @remarks Edges are preserved more aggressively as the sample count grows,
+  *          so that a converged image is left nearly unchanged.
+**/
+void atrous(constant struct Frm_Info *frm_info,
+            global            float4 *ftr_data,
+            global            float4 *src,
+            global            float4 *dst,
+                                 int  step);
@@ -19,6 +19,12 @@
   * This structure contains details about the frame buffer, its dimensions, and
   * other data relating to the current frame being rendered (it should not need
   * to be parsed by any unit other than this source file).
+  *
+  * The frame may be a tile of a larger image, in which case work items render
+  * the pixels of the tile but with the coordinates they have in the image. It
+  * may also be rendered at a lower resolution than the output texture, which
+  * it is then upscaled to (so kernels writing the output have one work item
+  * per output pixel, see \c has_output()).
 **/
 struct Frm_Info;
 
@@ -31,8 +37,25 @@ struct Frm_Info;
 **/
 bool has_work(constant struct Frm_Info *frm_info);
 
+/** Checks whether this work item has an output pixel to write.
+  *
+  * @param frm_info  The frame information structure.
+  *
+  * @return \c false if no output pixel is available for this work item - in
+  *         which case it should just return immediately - \c true otherwise.
+**/
+bool has_output(constant struct Frm_Info *frm_info);
+
+/** Resolves the (x, y) integer output pixel of a work item, from the top left.
+  *
+  * @param frm_info  The frame information structure.
+  *
+  * @return The work item's output pixel.
+**/
+int2 output_pixel(constant struct Frm_Info *frm_info);
+
 /** Computes the frame counter, a monotonically increasing integer, incremented
-  * each frame (useful for selecting which subsampler sample point to use).
+  * each frame (even when the frame is cleared).
   *
   * @param frm_info  The frame information structure.
   *
@@ -42,7 +65,20 @@ bool has_work(constant struct Frm_Info *frm_info);
 **/
 ulong get_counter(constant struct Frm_Info *frm_info);
 
-/** Resolves the (x, y) integer screen coordinates of a work item.
+/** Computes the sample index, the number of samples accumulated in the frame
+  * since it was last cleared (useful for selecting which subsample table entry
+  * to use, as each accumulation then starts at the beginning of the table).
+  *
+  * @param frm_info  The frame information structure.
+  *
+  * @return The sample index for this frame.
+  *
+  * @remarks The value returned will be the same for all work items.
+**/
+uint get_sample(constant struct Frm_Info *frm_info);
+
+/** Resolves the (x, y) integer screen coordinates of a work item (within the
+  * entire image, if the frame is a tile).
   *
   * @param frm_info  The frame information structure.
   *
@@ -63,7 +99,7 @@ float2 get_uv(constant struct Frm_Info *frm_info, float2 p);
   *
   * @param frm_info  The frame information structure.
   *
-  * @return The aspect ratio (width over height).
+  * @return The aspect ratio (width over height) of the entire image.
 **/
 float get_ratio(constant struct Frm_Info *frm_info);
 
@@ -80,7 +116,8 @@ void accumulate(constant struct Frm_Info *frm_info,
                 global            float4 *frm_data,
                                   float3  computed);
 
-/** Gets the color stored in the frame buffer for a given kernel work item.
+/** Gets the color stored in the frame buffer for the output pixel of a given
+  * kernel work item, bilinearly upscaled if the frame has a lower resolution.
   *
   * @param frm_info  The frame information structure.
   * @param frm_data  The frame buffer.
@@ -90,15 +127,60 @@ void accumulate(constant struct Frm_Info *frm_info,
 float3 get_color(constant struct Frm_Info *frm_info,
                  global            float4 *frm_data);
 
-/** Copies this work item's frame buffer value to the output texture.
+/** Stores the features of the primary hit for this work item, which are used
+  * to guide the denoising filter (see `filter.cl`). Unlike colors, they don't
+  * get accumulated but are overwritten on each sample.
+  *
+  * @param frm_info  The frame information structure.
+  * @param ftr_data  The feature buffer.
+  * @param normal    The surface normal at the primary hit.
+  * @param depth     The distance to the primary hit, or a negative value if
+  *                  the camera ray did not hit any geometry.
+**/
+void store_features(constant struct Frm_Info *frm_info,
+                    global            float4 *ftr_data,
+                                      float3  normal,
+                                      float   depth);
+
+/** Stores the material of the primary hit for this work item, if arbitrary
+  * output variables (AOV's) were requested for this frame. Together with the
+  * features, this gives the depth, normal and material AOV's from the single
+  * traversal done by the render kernel.
+  *
+  * @param frm_info  The frame information structure.
+  * @param mat_data  The material buffer.
+  * @param material  The material ID, or \c NO_MATERIAL if there was no hit.
+**/
+void store_material(constant struct Frm_Info *frm_info,
+                    global              uint *mat_data,
+                                        uint  material);
+
+/** The material ID stored when the camera ray did not hit any geometry (this
+  * is outside the range of valid material ID's).
+**/
+#define NO_MATERIAL 0xFFFF
+
+/** Locates a pixel at some offset from the pixel of this work item, so that
+  * kernels may gather from neighbouring pixels in the frame buffer.
+  *
+  * @param frm_info  The frame information structure.
+  * @param offset    The offset, in pixels.
+  * @param index     The frame buffer index of the pixel.
+  *
+  * @return \c true if the pixel lies within the frame, \c false otherwise (in
+  *         which case \c *index is undefined and should not be used).
+**/
+bool neighbour(constant struct Frm_Info *frm_info, int2 offset, size_t *index);
+
+/** Writes a display color for this work item's output pixel to the texture.
   *
   * @param frm_info  The frame information structure.
-  * @param frm_data  The frame buffer.
   * @param tex_data  The output texture.
+  * @param color     The display color.
 **/
-void tex_copy(constant struct Frm_Info *frm_info,
-              global            float4 *frm_data,
-              write_only     image2d_t  tex_data);
+void tex_write(constant struct Frm_Info *frm_info,
+               write_only     image2d_t  tex_data,
+                                 float3  color);
 
 /** This function returns an ID, uniquely identifying the current frame and the
   * current work item such that no two work items from any frame share the same
@@ -7,6 +7,17 @@
   * This unit provides traversal and occlusion facilities to the integrator, in
   * order to help evaluate the light transport integral. Its only input is a 1D
   * array of sparse voxel octree nodes, provided by the host.
+  *
+  * The world is a uniform grid of chunks, each with its own octree, such that
+  * it can grow in extent without deepening the trees. Rays walk through the
+  * grid cells front to back, descending into the octree of each chunk in turn.
+  * The host only keeps the chunks near the view resident, and the others are
+  * skipped as if they were empty.
+  *
+  * The nodes are streamed in by the host, a page of nodes at a time. When any
+  * ray reaches a page which is not resident, the page gets requested, and the
+  * bounding cube of its subtree is treated as a leaf until the page is loaded
+  * (i.e. the geometry is coarser where it is not resident yet).
 **/
 
 #pragma once
@@ -21,6 +32,7 @@
 struct Hit_Info
 {
     struct Basis basis;
+    uint material; // 15-bit material ID of the leaf
 };
 
 /** @struct Geometry
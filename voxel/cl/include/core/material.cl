@@ -1,26 +1,43 @@
-/** @file material.cl
+/* OpenCL 1.2 --- core/material.cl                                  INTERFACE */
+
+/** @file include/core/material.cl
   *
   * @brief Kernel Material Utilities
+  *
+  * Leaves of the geometry carry a 15-bit material ID (see \c Hit_Info), which
+  * indexes a compact table of materials built by the host. The table resides
+  * in constant memory, so that shading a hit costs no global memory fetches.
+  *
+  * Each entry is packed into eight bytes: an RGB8 albedo and an RGB9E5 shared
+  * exponent emission (which retains the high dynamic range of light sources).
+  * Heavyweight materials (tabulated 2D BRDF's and their inverse-sampled forms)
+  * are meant to be passed as image arrays to the render kernel instead.
 **/
 
 #pragma once
 
-// for surface BRDF's
-
-// direct sampling (returns the reflectance for two angles)
-float3 reflectance(float NdV, float NdL, read_only image2d_array_t material)
-{
-    return 0;
-}
-
-// importance sampling (takes an incident, a uniform, and returns an exitant
-// angle such that angles with the greatest reflectance are preferred. also
-// returns said reflectance in the XYZ components, W = exitant angle)
-float4 reflectance(float NdV, read_only image2d_array_t sampling)
+/** @struct Material
+  *
+  * A decoded material, describing a diffuse surface which may emit light.
+**/
+struct Material
 {
-    return 0;
-}
+    float3 albedo;
+    float3 emission;
+};
 
-// for phase BRDF's
+/** @struct Mtl_Table
+  *
+  * The material table (the layout of which is private to this unit).
+**/
+struct Mtl_Table;
 
-// to be decided
+/** Looks up and decodes a material from the material table.
+  *
+  * @param mtl_table  The material table.
+  * @param id         The material ID.
+  *
+  * @return The material, or the table's first (default) material if there is
+  *         no material with this ID.
+**/
+struct Material get_material(constant struct Mtl_Table *mtl_table, uint id);
@@ -140,3 +140,14 @@ float3 transform(float3 v, struct Basis basis);
   * @param prng  A pseudorandom number generator instance.
 **/
 float3 cosine(struct PRNG *prng);
+
+/** Maps a point of the unit square to an exitant vector, in normal space, such
+  * that uniformly distributed points give a cosine-weighted distribution.
+  *
+  * @param u  A point in [0..1)^2 (e.g. from a sampler).
+  *
+  * @return A cosine-weighted vector.
+  *
+  * @remarks This preserves the stratification of the input points.
+**/
+float3 cosine_warp(float2 u);
@@ -0,0 +1,33 @@
+/* OpenCL 1.2 --- core/post_proc.cl                                 INTERFACE */
+
+/** @file include/core/post_proc.cl
+  *
+  * @brief Kernel Post-Processing
+  *
+  * This unit converts the linear radiance stored in the frame buffer into the
+  * displayable 8-bit color written to the interop image. It is fused into the
+  * copy kernel so that the frame buffer is still only read once per pixel.
+  *
+  * The steps are, in order: exposure, tonemapping (which compresses the range
+  * of intensities instead of clipping them), sRGB encoding and dithering (the
+  * latter hides the banding caused by quantizing smooth gradients to 8 bits).
+**/
+
+#pragma once
+
+/** @struct Pst_Info
+  *
+  * This structure contains the post-processing settings, as set by the host.
+**/
+struct Pst_Info;
+
+/** Post-processes a linear color for display.
+  *
+  * @param pst_info  The post-processing settings.
+  * @param color     The linear color (as accumulated by the renderer).
+  * @param pixel     The integer pixel coordinates (used for dithering).
+  *
+  * @return The display color, in [0..1] and ready to be quantized.
+**/
+float3 post_process(constant struct Pst_Info *pst_info, float3 color,
+                    int2 pixel);
@@ -5,9 +5,11 @@
   * @brief Kernel PRNG Provider
   *
   * This unit provides pseudorandom number generation capabilities to a kernel,
-  * by implementing an efficient PRNG suitable for parallel architectures.
+  * on top of an efficient PRNG suitable for parallel architectures.
   *
-  * The algorithm implemented here is a variation of Threefish-256.
+  * The algorithm itself is provided by a generator module, selected at link
+  * time (see `modules/generator.cl`), while this unit converts its raw output
+  * into the various kinds of numbers below.
 **/
 
 #pragma once
@@ -16,17 +18,22 @@
   *
   * This structure contains the internal state of a PRNG, in order to calculate
   * pseudorandom numbers efficiently - each work item should have its own.
+  *
+  * @remarks Generators interpret the state as they see fit, and may well not
+  *          use all of it (unused parts can then be optimized away).
 **/
 struct PRNG
 {
     ulong4 state, key;
 };
 
-/** This function creates a new PRNG state, and initializes it to zero.
+/** This function creates a new PRNG state, seeded from an instance ID.
   *
   * @param instance_id  The ID to create the PRNG with, must be unique.
   *
   * @returns A new PRNG state, ready for use.
+  *
+  * @remarks This is implemented by the generator module.
 **/
 struct PRNG prng_init(ulong4 instance_id);
 
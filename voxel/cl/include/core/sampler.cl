@@ -0,0 +1,67 @@
+/* OpenCL 1.2 --- core/sampler.cl                                   INTERFACE */
+
+/** @file include/core/sampler.cl
+  *
+  * @brief Kernel Sampler
+  *
+  * This unit provides low-discrepancy sample points to integrators, which can
+  * use them in place of pseudorandom numbers wherever they sample a domain of
+  * integration (e.g. the hemisphere above a surface for ambient occlusion) so
+  * that their variance falls faster than the usual Monte Carlo rate.
+  *
+  * The points come from an Owen-scrambled Sobol (0,2)-sequence, indexed by the
+  * sample index (so that each accumulation is a prefix of the sequence), with
+  * each pixel getting its own scrambling seed so that the error of neighbouring
+  * pixels is decorrelated (Burley, "Practical Hash-based Owen Scrambling",
+  * 2020). Every two dimensions drawn from a sampler use an
+  * independently shuffled sequence, so that bounces do not correlate.
+**/
+
+#pragma once
+
+/** @struct Sampler
+  *
+  * This structure contains the state of a sampler - each work item should have
+  * its own, for the duration of one sample.
+**/
+struct Sampler
+{
+    uint index, seed, dim;
+};
+
+/** Creates a new sampler for a work item.
+  *
+  * @param instance_id  The work item's ID (see \c guid() in `frame_io.cl`),
+  *                     of which the pixel and the frame counter are used.
+  * @param index        The sample index (see \c get_sample()).
+  *
+  * @return A new sampler, positioned at its first dimension.
+  *
+  * @remarks The scrambling seeds change from one accumulation to the next, so
+  *          that the error of frames rendered while moving is decorrelated.
+**/
+struct Sampler sampler_init(ulong4 instance_id, uint index);
+
+/** Draws the next two dimensions of the sample point.
+  *
+  * @param sampler  A pointer to a sampler.
+  *
+  * @return Two stratified reals in [0..1).
+**/
+float2 sample2(struct Sampler *sampler);
+
+/** Derives a sampler for one of several points drawn together per sample (for
+  * instance, one per ray when several rays are traced from each hit) so that
+  * all of the points, across samples, form a single stratified sequence.
+  *
+  * @param sampler  A pointer to a sampler.
+  * @param count    The number of points drawn per sample.
+  * @param k        The point to derive the sampler for, in [0..count).
+  *
+  * @return A sampler for the \c k-th point.
+  *
+  * @remarks The derived samplers draw the same dimensions as \c sampler does,
+  *          so \c sampler itself should not be drawn from any further.
+**/
+struct Sampler sampler_batch(const struct Sampler *sampler, uint count,
+                             uint k);
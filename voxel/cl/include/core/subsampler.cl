@@ -0,0 +1,27 @@
+/* OpenCL 1.2 --- core/subsampler.cl                                INTERFACE */
+
+/** @file include/core/subsampler.cl
+  *
+  * @brief Kernel Subsampler
+  *
+  * A subsampler provides, for some integer between \f$0\f$ and \f$n\f$, a two
+  * dimensional offset \f$(\mathrm{d}x, \mathrm{d}y)\f$, called a sample point,
+  * which offsets the position of a pixel on an image and allows the renderer
+  * to perform subpixel sampling, reducing aliasing.
+  *
+  * The sample points are read from a table generated on the host (see the \c
+  * SampleTable class), so that the pattern and its length \f$n\f$ can change
+  * at runtime, without recompiling anything.
+**/
+
+#pragma once
+
+/** Gets a sample point from the sample table, cycling through the table.
+  *
+  * @param smp_data   The sample table.
+  * @param smp_count  The number of sample points in the table (nonzero).
+  * @param index      The sample point index (e.g. the sample index).
+  *
+  * @return The sample point, as an offset in pixels within [-0.5, 0.5).
+**/
+float2 subsample(global const float2 *smp_data, uint smp_count, ulong index);
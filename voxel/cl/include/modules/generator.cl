@@ -0,0 +1,27 @@
+/* OpenCL 1.2 --- modules/generator.cl                              INTERFACE */
+
+/** @file generator.cl
+  *
+  * @brief Kernel PRNG Generator Interface
+  *
+  * A generator is the pseudorandom number generation algorithm underlying the
+  * PRNG unit (see `core/prng_lib.cl`). It is given the PRNG state to seed (by
+  * implementing \c prng_init()) and then to advance, and only needs to output
+  * uniformly distributed bits, which are turned into numbers by the PRNG unit.
+  *
+  * Generators trade statistical quality for speed, and their relative speeds
+  * vary a lot between devices (e.g. depending on 64-bit integer throughput),
+  * so they can be compared with the \c prng_bench kernel.
+**/
+
+#pragma once
+
+#include <core/prng_lib.cl>
+
+/** Generates 128 pseudorandom bits, advancing the PRNG state.
+  *
+  * @param prng  A pointer to a PRNG state.
+  *
+  * @return Four uniformly distributed pseudorandom 32-bit integers.
+**/
+uint4 generate(struct PRNG *prng);
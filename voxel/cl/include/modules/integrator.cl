@@ -17,23 +17,37 @@
   *
   * Integrators take as an input the geometry and a camera ray, and will return
   * an RGB color describing the color and intensity of the light perceived from
-  * this camera ray.
+  * this camera ray. The nearest intersection of the camera ray is found by the
+  * render kernel (which needs it anyway for the denoising features) and given
+  * to the integrator, so that it need not be computed again.
 **/
 
 #pragma once
 
 #include <core/geometry.cl>
+#include <core/material.cl>
 #include <core/math_lib.cl>
 #include <core/prng_lib.cl>
+#include <core/sampler.cl>
 
 /** Integrates perceived light intensity along a camera ray.
   *
   * @remarks This will be called multiple times and the results averaged.
   *
-  * @param geometry  The geometry data.
   * @param ray       The camera ray.
+  * @param distance  The distance to the camera ray's nearest intersection.
+  * @param hit       The nearest intersection information, or zero if the
+  *                  camera ray did not hit anything (then \c distance is
+  *                  undefined and should not be used).
+  * @param geometry  The geometry data.
+  * @param materials The material table, indexed by \c Hit_Info::material.
+  * @param prng      The pseudorandom number generator.
+  * @param sampler   The low-discrepancy sampler, to be preferred over the
+  *                  generator for sampling any domain of integration.
   *
   * @return A vector representing RGB intensity along this ray.
 **/
-float3 integrate(struct Ray ray, global struct Geometry *geometry,
-                 struct PRNG *prng);
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler);
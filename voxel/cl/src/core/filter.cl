@@ -0,0 +1,63 @@
+/* OpenCL 1.2 --- core/filter.cl                               IMPLEMENTATION */
+
+#include <core/filter.cl>
+
+/* Edge-stopping parameters, for color (at one sample), normal and depth. The *
+ * depth tolerance is relative to the distance and proportional to the step. */
+#define PHI_COLOR  1.0f
+#define PHI_NORMAL 64.0f
+#define PHI_DEPTH  0.05f
+
+constant float taps[3] = {3.0f / 8, 1.0f / 4, 1.0f / 16}; // B3 spline
+
+static float edge_weight(float3 c0, float4 f0, float3 c1, float4 f1,
+                         float phi_color, int step)
+{
+    if ((f0.w < 0) || (f1.w < 0)) // sky only blends with sky
+        return ((f0.w < 0) && (f1.w < 0)) ? 1 : 0;
+
+    float3 dc = c0 - c1;
+    float w_c = exp(-dot(dc, dc) / (phi_color * phi_color));
+    float w_n = pow(max(0.0f, dot(f0.xyz, f1.xyz)), PHI_NORMAL);
+    float w_z = exp(-fabs(f0.w - f1.w) / (PHI_DEPTH * step * f0.w + 1e-4f));
+
+    return w_c * w_n * w_z;
+}
+
+void atrous(constant struct Frm_Info *frm_info,
+            global            float4 *ftr_data,
+            global            float4 *src,
+            global            float4 *dst,
+                                 int  step)
+{
+    size_t center, index;
+    neighbour(frm_info, (int2)(0, 0), &center);
+
+    float4 f0 = ftr_data[center];
+    float n = src[center].w; // number of samples
+    float3 c0 = src[center].xyz / n;
+
+    /* The noise decreases as 1 / sqrt(n), and each pass further halves it. */
+    float phi_color = PHI_COLOR / (step * sqrt(n));
+
+    float3 sum = 0;
+    float total = 0;
+
+    for (int y = -2; y <= 2; ++y)
+        for (int x = -2; x <= 2; ++x)
+        {
+            if (!neighbour(frm_info, (int2)(x, y) * step, &index))
+                continue;
+
+            float4 f1 = ftr_data[index];
+            float3 c1 = src[index].xyz / src[index].w;
+
+            float w = taps[abs(x)] * taps[abs(y)]
+                    * edge_weight(c0, f0, c1, f1, phi_color, step);
+
+            sum += w * c1;
+            total += w;
+        }
+
+    dst[center] = (float4)(sum / total * n, n); // keep RGBn format
+}
@@ -4,34 +4,63 @@
 
 struct Frm_Info
 {
-    uint2 dim;
+    uint2 dim; // of the frame (or tile)
+    uint2 off; // tile offset in image
+    uint2 img; // of the entire image
+    uint2 out; // of the output texture
     ulong ctr;
+    uint aov; // whether to store AOV's
+    uint smp; // sample index since clear
 };
 
+/* Returns the pixel of this work item relative to the frame (or tile), with *
+ * the rows of the frame buffer going from the top of the frame downwards.  */
+static int2 local_pixel(constant struct Frm_Info *frm_info)
+{
+    return (int2)(get_global_id(0) % frm_info->dim.x,
+                  get_global_id(0) / frm_info->dim.x);
+}
+
 bool has_work(constant struct Frm_Info *frm_info)
 {
     return get_global_id(0) < frm_info->dim.x * frm_info->dim.y;
 }
 
+bool has_output(constant struct Frm_Info *frm_info)
+{
+    return get_global_id(0) < frm_info->out.x * frm_info->out.y;
+}
+
+int2 output_pixel(constant struct Frm_Info *frm_info)
+{
+    return (int2)(get_global_id(0) % frm_info->out.x,
+                  get_global_id(0) / frm_info->out.x);
+}
+
 ulong get_counter(constant struct Frm_Info *frm_info)
 {
     return frm_info->ctr;
 }
 
+uint get_sample(constant struct Frm_Info *frm_info)
+{
+    return frm_info->smp;
+}
+
 float2 resolve(constant struct Frm_Info *frm_info)
 {
-    return (float2)(get_global_id(0) % frm_info->dim.x,
-                    frm_info->dim.y - 1 - get_global_id(0) / frm_info->dim.x);
+    int2 p = local_pixel(frm_info) + convert_int2(frm_info->off);
+    return (float2)(p.x, frm_info->img.y - 1 - p.y);
 }
 
 float2 get_uv(constant struct Frm_Info *frm_info, float2 p)
 {
-    return (p / convert_float2(frm_info->dim.xy));
+    return (p / convert_float2(frm_info->img.xy));
 }
 
 float get_ratio(constant struct Frm_Info *frm_info)
 {
-    return (float)frm_info->dim.x / (float)frm_info->dim.y;
+    return (float)frm_info->img.x / (float)frm_info->img.y;
 }
 
 void accumulate(constant struct Frm_Info *frm_info,
@@ -41,26 +70,76 @@ void accumulate(constant struct Frm_Info *frm_info,
     frm_data[get_global_id(0)] += (float4)(computed, 1);
 }
 
+static float3 fetch(constant struct Frm_Info *frm_info,
+                    global            float4 *frm_data, int2 p)
+{
+    float4 color = frm_data[p.y * frm_info->dim.x + p.x];
+    return color.xyz / color.w; // RGBn format
+}
+
 float3 get_color(constant struct Frm_Info *frm_info,
                  global            float4 *frm_data)
 {
-    float4 color = frm_data[get_global_id(0)];
-    return color.xyz / color.w; // RGBn format
+    int2 p = output_pixel(frm_info);
+
+    if (all(frm_info->out == frm_info->dim))
+        return fetch(frm_info, frm_data, p);
+
+    /* The frame is rendered at a reduced resolution, so upscale bilinearly. */
+    float2 dim = convert_float2(frm_info->dim), max_p = dim - 1;
+    float2 src = (convert_float2(p) + 0.5f) / convert_float2(frm_info->out);
+    src = clamp(src * dim - 0.5f, (float2)(0), max_p);
+
+    float2 base = floor(src), f = src - base;
+    int2 p0 = convert_int2(base);
+    int2 p1 = convert_int2(min(base + 1, max_p));
+
+    float3 top = mix(fetch(frm_info, frm_data, p0),
+                     fetch(frm_info, frm_data, (int2)(p1.x, p0.y)), f.x);
+    float3 bottom = mix(fetch(frm_info, frm_data, (int2)(p0.x, p1.y)),
+                        fetch(frm_info, frm_data, p1), f.x);
+    return mix(top, bottom, f.y);
+}
+
+void store_features(constant struct Frm_Info *frm_info,
+                    global            float4 *ftr_data,
+                                      float3  normal,
+                                      float   depth)
+{
+    ftr_data[get_global_id(0)] = (float4)(normal, depth);
+}
+
+void store_material(constant struct Frm_Info *frm_info,
+                    global              uint *mat_data,
+                                        uint  material)
+{
+    if (frm_info->aov) mat_data[get_global_id(0)] = material;
+}
+
+bool neighbour(constant struct Frm_Info *frm_info, int2 offset, size_t *index)
+{
+    int2 dim = convert_int2(frm_info->dim);
+    int2 pos = local_pixel(frm_info) + offset;
+
+    *index = pos.y * dim.x + pos.x;
+    return all(pos >= 0) && all(pos < dim);
 }
 
-void tex_copy(constant struct Frm_Info *frm_info,
-              global            float4 *frm_data,
-              write_only     image2d_t  tex_data)
+void tex_write(constant struct Frm_Info *frm_info,
+               write_only     image2d_t  tex_data,
+                                 float3  color)
 {
-    write_imagef(tex_data, convert_int2(resolve(frm_info)),
-                 (float4)(get_color(frm_info, frm_data), 1));
+    int2 p = output_pixel(frm_info);
+    write_imagef(tex_data, (int2)(p.x, frm_info->out.y - 1 - p.y),
+                 (float4)(color, 1));
 }
 
 ulong4 guid(constant struct Frm_Info *frm_info)
 {
-    ulong frame_id = upsample(frm_info->dim.x, frm_info->dim.y);
+    ulong frame_id = upsample(frm_info->img.x, frm_info->img.y);
+    int2 p = local_pixel(frm_info) + convert_int2(frm_info->off);
 
-    return (ulong4)(get_global_id(0),
+    return (ulong4)(p.y * frm_info->img.x + p.x, // unique across tiles
                     get_global_id(1),
                     frm_info->ctr,
                     frame_id);
@@ -3,12 +3,157 @@
 #include <core/geometry.cl>
 #include <core/math_lib.cl>
 
-struct Geometry
+#define PAGE_NODES 1024 // see the PagedGeometry class
+#define REQUEST_SLOTS 1024
+
+#define CHUNK_SIZE 2.0f // see the ChunkGrid class
+#define MAX_CHUNK_LEVELS 8 // see SVOBuilder::MAX_DEPTH
+#define NO_CHUNK 0xFFFFFFFF
+
+#define LEAF_FLAG 0x80000000
+#define PAGE_FLAG 0x40000000
+
+typedef struct SVO_NODE
 {
     uint child[8];
+} SVO_NODE;
+
+/* The geometry is a header, followed by the root node of the chunk in each  *
+ * cell of the grid (padded to a whole node), a pool of page slots, and the *
+ * frame each slot was last used in. Child pointers with PAGE_FLAG set refer *
+ * to pages not resident, and cells of chunks not resident hold NO_CHUNK.   *
+ * The pool starts with an unused node, so that no node has pointer zero.   */
+struct Geometry
+{
+    uint frame, slots;
+    uint width, height, depth, padding[3]; // of the grid, in cells
+    uint request[REQUEST_SLOTS]; // page ID + 1, or zero
 };
 
-typedef struct Geometry SVO_NODE;
+static global uint *get_cells(global struct Geometry *geometry)
+{
+    return (global uint *)(geometry + 1);
+}
+
+static global SVO_NODE *get_pool(global struct Geometry *geometry)
+{
+    uint cells = geometry->width * geometry->height * geometry->depth;
+    return (global SVO_NODE *)get_cells(geometry) + (cells + 7) / 8;
+}
+
+/* Returns the slot holding a node (see PagedGeometry::node_pointer). */
+static uint get_slot(uint offset)
+{
+    return (offset - 1) / PAGE_NODES;
+}
+
+/* Marks the page of a node as used this frame. */
+static void touch_page(global struct Geometry *geometry, uint offset)
+{
+    global SVO_NODE *pool = get_pool(geometry) + 1;
+    global uint *stamps = (global uint *)(pool + geometry->slots * PAGE_NODES);
+    stamps[get_slot(offset)] = geometry->frame;
+}
+
+/* Marks the page of a child as used this frame if it is a node in another  *
+ * page than its parent (as pages are only ever entered from their parent). */
+static void touch_child(global struct Geometry *geometry, uint parent,
+                        uint child)
+{
+    if (!(child & (LEAF_FLAG | PAGE_FLAG))
+     && (get_slot(child) != get_slot(parent)))
+        touch_page(geometry, child);
+}
+
+/* Requests that a page be made resident (requests with the same hash may    *
+ * well overwrite one another, but they will just be made again next frame). */
+static void request_page(global struct Geometry *geometry, uint page)
+{
+    geometry->request[page % REQUEST_SLOTS] = page + 1;
+}
+
+/* Walks through the cells of the chunk grid along a ray, front to back with *
+ * a 3D DDA (the grid being centered on the origin).                         */
+typedef struct GRID_WALK
+{
+    int3 cell, step, size;
+    float3 next, delta; // distance to the next cell boundary, per axis
+    float3 origin;      // of the grid
+    float t, end;
+} GRID_WALK;
+
+/* Starts a walk at the first cell the ray enters within a range, returning *
+ * false if the ray misses the grid within that range.                      */
+static bool walk_begin(global struct Geometry *geometry, const struct Ray ray,
+                       float3 invdir, float range, GRID_WALK *walk)
+{
+    walk->size = (int3)(geometry->width, geometry->height, geometry->depth);
+    walk->origin = -convert_float3(walk->size) * (CHUNK_SIZE * 0.5f);
+
+    float3 a = (walk->origin - ray.o) * invdir;
+    float3 b = (-walk->origin - ray.o) * invdir;
+    float3 u = fmin(a, b), v = fmax(a, b);
+
+    walk->t = max(max(max(u.x, u.y), u.z), 0.0f);
+    walk->end = min(min(min(v.x, v.y), v.z), range);
+    if (walk->t >= walk->end) return false;
+
+    float3 p = (ray.o + ray.d * walk->t - walk->origin) / CHUNK_SIZE;
+    walk->cell = clamp(convert_int3_rtn(p), (int3)(0), walk->size - 1);
+    walk->step = select((int3)(-1), (int3)(+1), isgreaterequal(ray.d, (float3)(0)));
+
+    float3 boundary = walk->origin + CHUNK_SIZE
+                    * convert_float3(walk->cell + max(walk->step, 0));
+    walk->next = select((boundary - ray.o) * invdir, (float3)(INFINITY),
+                        isequal(ray.d, (float3)(0)));
+    walk->delta = fabs(invdir) * CHUNK_SIZE;
+
+    return true;
+}
+
+/* Moves on to the next cell, returning false when the walk leaves the grid *
+ * or the cell starts beyond the end of the range.                          */
+static bool walk_next(GRID_WALK *walk)
+{
+    if ((walk->next.x < walk->next.y) && (walk->next.x < walk->next.z))
+    {
+        walk->t = walk->next.x;
+        walk->next.x += walk->delta.x;
+        walk->cell.x += walk->step.x;
+    }
+    else if (walk->next.y < walk->next.z)
+    {
+        walk->t = walk->next.y;
+        walk->next.y += walk->delta.y;
+        walk->cell.y += walk->step.y;
+    }
+    else
+    {
+        walk->t = walk->next.z;
+        walk->next.z += walk->delta.z;
+        walk->cell.z += walk->step.z;
+    }
+
+    return (walk->t < walk->end) && all(walk->cell >= 0)
+                                 && all(walk->cell < walk->size);
+}
+
+/* Returns the root node pointer of the current cell's chunk (or NO_CHUNK). */
+static uint walk_chunk(global struct Geometry *geometry, const GRID_WALK *walk)
+{
+    int3 c = walk->cell;
+    return get_cells(geometry)[(c.z * walk->size.y + c.y) * walk->size.x + c.x];
+}
+
+static struct Box walk_cube(const GRID_WALK *walk)
+{
+    float3 l = walk->origin + convert_float3(walk->cell) * CHUNK_SIZE;
+    return (struct Box){l, l + CHUNK_SIZE};
+}
+
+/* A ray passes through at most four children of any node, so every level *
+ * below the root grows the stack by at most three items.                  */
+#define STACK_SIZE (3 * MAX_CHUNK_LEVELS + 1)
 
 typedef struct STACK_ITEM
 {
@@ -17,23 +162,23 @@ typedef struct STACK_ITEM
     struct Box cube;
 } STACK_ITEM;
 
-bool traverse(global struct Geometry *geometry,
-              const struct Ray ray, float range,
-              float *nearest, struct Hit_Info *hit_info)
+/* Finds the nearest intersection with a chunk's octree closer than *nearest, *
+ * updating it and the intersected leaf if any, and returning whether it did. */
+static bool traverse_chunk(global struct Geometry *geometry, uint root,
+                           struct Box cube, const struct Ray ray,
+                           float3 invdir, float *nearest, STACK_ITEM *ns)
 {
-    STACK_ITEM stack[20];
+    STACK_ITEM stack[STACK_SIZE];
     size_t sp = 0;
 
-    stack[0].offset = 0;
+    stack[0].offset = root;
     stack[0].hit = -INFINITY;
-    stack[0].cube = (struct Box){(float3)(-1, -1, -1), (float3)(+1, +1, +1)};
+    stack[0].cube = cube;
     ++sp;
 
-    float3 invdir = native_recip(ray.d); // ??
-
-    *nearest = range;
-
-    STACK_ITEM ns;
+    global SVO_NODE *pool = get_pool(geometry);
+    touch_page(geometry, root);
+    bool found = false;
 
     while (sp)
     {
@@ -41,15 +186,31 @@ bool traverse(global struct Geometry *geometry,
 
         if (s.hit < *nearest)
         {
-            if (s.offset & 0x80000000)
+            if (s.offset & LEAF_FLAG)
             {
-                s.offset ^= 0x80000000; /* Decode this leaf offset. */
+                s.offset ^= LEAF_FLAG; /* Decode this leaf offset. */
                 *nearest = s.hit;
-                ns = s;
+                *ns = s;
+                found = true;
+            }
+            else if (s.offset & PAGE_FLAG)
+            {
+                /* Until the page is resident, its cube stands in for it as *
+                 * a leaf (unless the ray starts inside, as it would occlude *
+                 * everything), with the default material.                  */
+                request_page(geometry, s.offset ^ PAGE_FLAG);
+
+                if (s.hit >= 0)
+                {
+                    *nearest = s.hit;
+                    *ns = s;
+                    ns->offset = 0;
+                    found = true;
+                }
             }
             else
             {
-                SVO_NODE current = geometry[s.offset];
+                SVO_NODE current = pool[s.offset];
                 for (size_t t = 0; t < 8; ++t)
                 {
                     uint child = current.child[t];
@@ -60,32 +221,70 @@ bool traverse(global struct Geometry *geometry,
                     node.cube = subdivide(s.cube, t);
 
                     if (intersect(ray, node.cube, invdir, &node.hit))
-                        if (node.hit < *nearest) stack[sp++] = node;
+                        if (node.hit < *nearest)
+                        {
+                            touch_child(geometry, s.offset, child);
+                            stack[sp++] = node;
+                        }
                 }
             }
         }
     }
 
+    return found;
+}
+
+bool traverse(global struct Geometry *geometry,
+              const struct Ray ray, float range,
+              float *nearest, struct Hit_Info *hit_info)
+{
+    float3 invdir = native_recip(ray.d); // ??
+
+    *nearest = range;
+
+    STACK_ITEM ns;
+    GRID_WALK walk;
+
+    if (!walk_begin(geometry, ray, invdir, range, &walk)) return false;
+
+    /* Any intersection lies within the chunk it is found in, so the first *
+     * one found is the nearest as the cells are visited front to back.   */
+    do
+    {
+        uint root = walk_chunk(geometry, &walk);
+
+        if (root != NO_CHUNK)
+            if (traverse_chunk(geometry, root, walk_cube(&walk), ray, invdir,
+                               nearest, &ns)) break;
+    }
+    while (walk_next(&walk));
+
+    if (*nearest >= range) return false;
+
     if (hit_info)
     {
         hit_info->basis = box_basis(ray, ns.cube, invdir);
+        hit_info->material = (ns.offset >> 16) & 0x7FFF;
     }
 
-    return *nearest < range;
+    return true;
 }
 
-bool occlude(global struct Geometry *geometry,
-             const struct Ray ray, float range)
+/* Returns whether a chunk's octree intersects the ray closer than range. */
+static bool occlude_chunk(global struct Geometry *geometry, uint root,
+                          struct Box cube, const struct Ray ray,
+                          float3 invdir, float range)
 {
-    STACK_ITEM stack[20];
+    STACK_ITEM stack[STACK_SIZE];
     size_t sp = 0;
 
-    stack[0].offset = 0;
+    stack[0].offset = root;
     stack[0].hit = 0;
-    stack[0].cube = (struct Box){(float3)(-1, -1, -1), (float3)(+1, +1, +1)};
+    stack[0].cube = cube;
     ++sp;
 
-    float3 invdir = native_recip(ray.d);
+    global SVO_NODE *pool = get_pool(geometry);
+    touch_page(geometry, root);
 
     while (sp)
     {
@@ -93,13 +292,18 @@ bool occlude(global struct Geometry *geometry,
 
         if (s.hit < range)
         {
-            if (s.offset & 0x80000000)
+            if (s.offset & LEAF_FLAG)
             {
                 return true;
             }
+            else if (s.offset & PAGE_FLAG)
+            {
+                request_page(geometry, s.offset ^ PAGE_FLAG);
+                if (s.hit >= 0) return true; /* As in traverse_chunk(). */
+            }
             else
             {
-                SVO_NODE current = geometry[s.offset];
+                SVO_NODE current = pool[s.offset];
                 for (size_t t = 0; t < 8; ++t)
                 {
                     uint child = current.child[t];
@@ -110,7 +314,11 @@ bool occlude(global struct Geometry *geometry,
                     node.cube = subdivide(s.cube, t);
 
                     if (intersect(ray, node.cube, invdir, &node.hit))
-                        if (node.hit < range) stack[sp++] = node;
+                        if (node.hit < range)
+                        {
+                            touch_child(geometry, s.offset, child);
+                            stack[sp++] = node;
+                        }
                 }
             }
         }
@@ -119,6 +327,27 @@ bool occlude(global struct Geometry *geometry,
     return false;
 }
 
+bool occlude(global struct Geometry *geometry,
+             const struct Ray ray, float range)
+{
+    float3 invdir = native_recip(ray.d);
+    GRID_WALK walk;
+
+    if (!walk_begin(geometry, ray, invdir, range, &walk)) return false;
+
+    do
+    {
+        uint root = walk_chunk(geometry, &walk);
+
+        if (root != NO_CHUNK)
+            if (occlude_chunk(geometry, root, walk_cube(&walk), ray, invdir,
+                              range)) return true;
+    }
+    while (walk_next(&walk));
+
+    return false;
+}
+
 bool occludes(global struct Geometry *geometry, const struct Ray ray,
               float range)
 {
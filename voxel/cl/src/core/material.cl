@@ -1,24 +1,32 @@
-/** @file material.cl
-  *
-  * @brief Kernel Material Utilities
-**/
+/* OpenCL 1.2 --- core/material.cl                             IMPLEMENTATION */
 
-// for surface BRDF's
+#include <core/material.cl>
 
-// direct sampling (returns the reflectance for two angles)
-float3 reflectance(float NdV, float NdL, read_only image2d_array_t material)
+#define MAX_MATERIALS 4096 // see the MaterialDB class
+
+struct Mtl_Table
+{
+    uint count, padding;
+    uint2 entry[MAX_MATERIALS];
+};
+
+static float3 unpack_unorm8(uint x)
 {
-    return 0;
+    return convert_float3((uint3)(x, x >> 8, x >> 16) & 0xFF) / 255;
 }
 
-// importance sampling (takes an incident, a uniform, and returns an exitant
-// angle such that angles with the greatest reflectance are preferred. also
-// returns said reflectance in the XYZ components, W = exitant angle)
-float4 reflectance(float NdV, read_only image2d_array_t sampling)
+static float3 unpack_rgb9e5(uint x)
 {
-    return 0;
+    float scale = exp2((float)(int)(x >> 27) - 24); // 15 bias, 9-bit mantissa
+    return convert_float3((uint3)(x, x >> 9, x >> 18) & 0x1FF) * scale;
 }
 
-// for phase BRDF's
+struct Material get_material(constant struct Mtl_Table *mtl_table, uint id)
+{
+    uint2 entry = mtl_table->entry[id < mtl_table->count ? id : 0];
 
-// to be decided
+    struct Material material;
+    material.albedo = unpack_unorm8(entry.x);
+    material.emission = unpack_rgb9e5(entry.y);
+    return material;
+}
@@ -98,7 +98,11 @@ float3 transform(float3 v, struct Basis basis)
 
 float3 cosine(struct PRNG *prng)
 {
-    float2 u = rand2(prng);
+    return cosine_warp(rand2(prng));
+}
+
+float3 cosine_warp(float2 u)
+{
     float t = 2*M_PI * u.x;
     float r = sqrt(u.y);
 
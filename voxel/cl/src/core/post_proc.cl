@@ -0,0 +1,69 @@
+/* OpenCL 1.2 --- core/post_proc.cl                            IMPLEMENTATION */
+
+#include <core/post_proc.cl>
+
+/* These must match PostProcess::Operator on the host. */
+#define TONEMAP_LINEAR   0
+#define TONEMAP_REINHARD 1
+#define TONEMAP_FILMIC   2
+
+struct Pst_Info
+{
+    float exposure; // linear scale
+    uint tonemap;
+    uint srgb;
+    uint dither;
+};
+
+/* John Hable's filmic curve (as used in Uncharted 2), with a white point. */
+static float3 hable(float3 x)
+{
+    const float A = 0.15f, B = 0.50f, C = 0.10f;
+    const float D = 0.20f, E = 0.02f, F = 0.30f;
+
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+static float3 tonemap(float3 color, uint op)
+{
+    const float white = 11.2f;
+
+    switch (op)
+    {
+        case TONEMAP_REINHARD:
+            return color / (1 + color);
+        case TONEMAP_FILMIC:
+            return hable(2 * color) / hable((float3)(white));
+        default:
+            return color;
+    }
+}
+
+static float3 srgb_encode(float3 c)
+{
+    float3 lo = c * 12.92f;
+    float3 hi = 1.055f * pow(c, (float3)(1 / 2.4f)) - 0.055f;
+    return select(hi, lo, isless(c, (float3)(0.0031308f)));
+}
+
+/* Interleaved gradient noise (Jimenez 2014) has most of its energy in high    *
+ * frequencies like blue noise, but needs no precomputed texture to look up. */
+static float gradient_noise(int2 pixel)
+{
+    float2 p = convert_float2(pixel);
+    float f = 0.06711056f * p.x + 0.00583715f * p.y;
+    float g = 52.9829189f * (f - floor(f));
+    return g - floor(g);
+}
+
+float3 post_process(constant struct Pst_Info *pst_info, float3 color,
+                    int2 pixel)
+{
+    color = tonemap(max(color, 0.0f) * pst_info->exposure, pst_info->tonemap);
+    color = clamp(color, 0.0f, 1.0f);
+
+    if (pst_info->srgb) color = srgb_encode(color);
+    if (pst_info->dither) color += (gradient_noise(pixel) - 0.5f) / 255;
+
+    return clamp(color, 0.0f, 1.0f);
+}
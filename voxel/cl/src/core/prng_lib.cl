@@ -1,50 +1,12 @@
 /* OpenCL 1.2 --- core/prng_lib.cl                             IMPLEMENTATION */
 
 #include <core/prng_lib.cl>
-
-static void renew(ulong4 *state, ulong4 seed)
-{
-    ulong4 block = *state + seed;
-
-    #pragma unroll
-    for (size_t t = 0; t < 4; t++)
-    {
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(14, 16));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(52, 57));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(23, 40));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)( 5, 37));
-        block.hi ^= block.lo; block = block.xywz;
-
-        block += seed;
-
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(25, 33));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(46, 12));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(58, 22));
-        block.hi ^= block.lo; block = block.xywz;
-        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(32, 32));
-        block.hi ^= block.lo; block = block.xywz;
-
-        block += seed;
-    }
-
-    *state ^= block;
-}
-
-struct PRNG prng_init(ulong4 instance_id)
-{
-    return (struct PRNG){0, instance_id};
-}
+#include <modules/generator.cl>
 
 float4 rand4(struct PRNG *prng)
 {
-    renew(&prng->state, prng->key);
-    const ulong hi = 18446744073709551615UL;
-    return convert_float4(prng->state) / hi;
+    /* Only 24 bits fit in a float's mantissa, keeping the result below one. */
+    return convert_float4(generate(prng) >> 8) * (1.0f / 16777216);
 }
 
 float3 rand3(struct PRNG *prng)
@@ -64,8 +26,7 @@ float rand(struct PRNG *prng)
 
 uint4 rand4i(struct PRNG *prng, uint n)
 {
-    renew(&prng->state, prng->key);
-    return convert_uint4(prng->state) % n;
+    return generate(prng) % n;
 }
 
 uint3 rand3i(struct PRNG *prng, uint n)
@@ -85,8 +46,8 @@ uint randi(struct PRNG *prng, uint n)
 
 ulong4 rand4l(struct PRNG *prng, ulong n)
 {
-    renew(&prng->state, prng->key);
-    return prng->state % n;
+    uint4 hi = generate(prng);
+    return upsample(hi, generate(prng)) % n;
 }
 
 ulong3 rand3l(struct PRNG *prng, ulong n)
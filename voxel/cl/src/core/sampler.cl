@@ -0,0 +1,76 @@
+/* OpenCL 1.2 --- core/sampler.cl                              IMPLEMENTATION */
+
+#include <core/sampler.cl>
+
+static uint reverse_bits(uint x)
+{
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+static uint hash(uint x)
+{
+    x ^= x >> 16; x *= 0x7FEB352D;
+    x ^= x >> 15; x *= 0x846CA68B;
+    return x ^ (x >> 16);
+}
+
+/* This is the Laine-Karras hash, which only lets each bit be affected by the *
+ * bits below it, so that scrambling the reversed bits is an Owen scramble.  */
+static uint owen_scramble(uint x, uint seed)
+{
+    x = reverse_bits(x) + seed;
+    x ^= x * 0x6C50B47C;
+    x ^= x * 0xB82F1E52;
+    x ^= x * 0xC7AFE638;
+    x ^= x * 0x8D22F6E6;
+    return reverse_bits(x);
+}
+
+/* The second Sobol dimension, whose direction numbers are v[i] = v[i - 1] ^ *
+ * (v[i - 1] >> 1), the first being the van der Corput radical inverse.     */
+static uint sobol_y(uint index)
+{
+    uint y = 0;
+
+    for (uint v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1)
+        if (index & 1) y ^= v;
+
+    return y;
+}
+
+struct Sampler sampler_init(ulong4 instance_id, uint index)
+{
+    /* The frame counter less the sample index is the same for every sample *
+     * of an accumulation, and different for every accumulation.            */
+    uint accumulation = (uint)(instance_id.z - index);
+
+    struct Sampler sampler;
+    sampler.index = index;
+    sampler.seed = hash((uint)instance_id.x ^ hash(accumulation));
+    sampler.dim = 0;
+    return sampler;
+}
+
+struct Sampler sampler_batch(const struct Sampler *sampler, uint count,
+                             uint k)
+{
+    struct Sampler batch = *sampler;
+    batch.index = sampler->index * count + k;
+    return batch;
+}
+
+float2 sample2(struct Sampler *sampler)
+{
+    uint seed = hash(sampler->seed ^ hash(sampler->dim++));
+    uint index = owen_scramble(sampler->index, seed);
+
+    uint2 p = (uint2)(owen_scramble(reverse_bits(index), hash(seed ^ 1)),
+                      owen_scramble(sobol_y(index), hash(seed ^ 2)));
+
+    /* Only 24 bits fit in a float's mantissa, keeping the result below one. */
+    return convert_float2(p >> 8) * (1.0f / 16777216);
+}
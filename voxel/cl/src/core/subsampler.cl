@@ -0,0 +1,8 @@
+/* OpenCL 1.2 --- core/subsampler.cl                           IMPLEMENTATION */
+
+#include <core/subsampler.cl>
+
+float2 subsample(global const float2 *smp_data, uint smp_count, ulong index)
+{
+    return smp_data[index % smp_count];
+}
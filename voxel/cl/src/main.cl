@@ -15,9 +15,14 @@
 
 #include <core/math_lib.cl>
 #include <core/prng_lib.cl>
+#include <core/sampler.cl>
 #include <core/frame_io.cl>
 #include <core/observer.cl>
 #include <core/geometry.cl>
+#include <core/material.cl>
+#include <core/post_proc.cl>
+#include <core/filter.cl>
+#include <core/subsampler.cl>
 
 /** Files in the `modules` folder are interfaces to the various types of module
   * such as projection models, integrators, and so on, which directly plug into
@@ -26,7 +31,6 @@
   * @remarks Modules are made available to the renderer at link time.
 **/
 
-#include <modules/subsampler.cl>
 #include <modules/projection.cl>
 #include <modules/integrator.cl>
 
@@ -40,15 +44,25 @@
   *
   * @param frm_info  The frame information structure, see `frame_io.cl`.
   * @param frm_data  The renderer's frame buffer encoded in RGBn format.
+  * @param ftr_data  The primary hit feature buffer, used for denoising.
+  * @param mat_data  The primary hit material buffer (written if requested).
+  * @param smp_data  The subsampler's table of sample points.
+  * @param smp_count The number of sample points in the table.
   * @param geometry  The sparse voxel octree (in compact tree encoding).
   * @param observer  The observer, which contains view-dependent params.
+  * @param mtl_table The packed material table, see `material.cl`.
   * @param material  The material tables (as a 2D isotropic BRDF array).
   * @param sampling  The material data as inverse-sampled distributions.
 **/
 kernel void render(constant  struct Frm_Info *frm_info,
                    global               void *frm_data,
+                   global               void *ftr_data,
+                   global               void *mat_data,
+                   global       const float2 *smp_data,
+                                        uint  smp_count,
                    global    struct Geometry *geometry,
-                   constant  struct Observer *observer
+                   constant  struct Observer *observer,
+                   constant struct Mtl_Table *mtl_table
                    /*read_only image2d_array_t  material,
                    read_only image2d_array_t  sampling*/)
 {
@@ -56,30 +70,70 @@ kernel void render(constant  struct Frm_Info *frm_info,
     {
         ulong4 id = guid(frm_info);
         struct PRNG rng = prng_init(id);
+        uint index = get_sample(frm_info);
+        struct Sampler sampler = sampler_init(id, index);
         float2 coords = resolve(frm_info);
         float ratio = get_ratio(frm_info);
 
-        size_t point = get_counter(frm_info) % sample_count();
-        float2 uv = get_uv(frm_info, coords  + sample(point));
+        float2 offset = subsample(smp_data, smp_count, index);
+        float2 uv = get_uv(frm_info, coords + offset);
         struct Ray ray = project(observer, uv.x, uv.y, ratio);
 
-        // TODO: pass materials/lights to integrator
+        /* The primary hit is shared by all integrators, and its features are *
+         * kept for the denoising filter (and as AOV's, if requested).        */
+        float distance;
+        struct Hit_Info hit;
+        bool found = intersects(geometry, ray, INFINITY, &distance, &hit);
+        store_features(frm_info, ftr_data, found ? hit.basis.n : (float3)(0),
+                                           found ? distance : -1);
+        store_material(frm_info, mat_data, found ? hit.material : NO_MATERIAL);
 
-        float3 color = integrate(ray, geometry, &rng);
+        float3 color = integrate(ray, distance, found ? &hit : 0,
+                                 geometry, mtl_table, &rng, &sampler);
         accumulate(frm_info, frm_data, color);
     }
 }
 
+/** This kernel runs one pass of the denoising filter (see `filter.cl`), and is
+  * run a few times between \c render and \c interop_copy when denoising.
+  *
+  * @param frm_info  The frame information structure, see `frame_io.cl`.
+  * @param ftr_data  The primary hit feature buffer.
+  * @param dns_src   The input buffer, in the frame buffer format.
+  * @param dns_dst   The output buffer, in the frame buffer format.
+  * @param dns_step  The step size of this pass (1, 2, 4, ...).
+**/
+kernel void denoise(constant  struct Frm_Info *frm_info,
+                    global               void *ftr_data,
+                    global               void *dns_src,
+                    global               void *dns_dst,
+                                          int  dns_step)
+{
+    if (has_work(frm_info))
+    {
+        atrous(frm_info, ftr_data, dns_src, dns_dst, dns_step);
+    }
+}
+
 /** This kernel is required to copy the frame buffer into the interop image, so
   * that the OpenGL implementation can display the frame buffer on the screen.
+  * Post-processing is fused into this copy (see `post_proc.cl`), so the frame
+  * buffer is still read only once per pixel.
   *
   * @param frm_info  The frame information structure, see `frame_io.cl`.
   * @param frm_data  The renderer's frame buffer encoded in RGBn format.
+  * @param pst_info  The post-processing settings, see `post_proc.cl`.
   * @param tex_data  The interop image (of a compatible texture format).
 **/
 kernel void interop_copy(constant  struct Frm_Info *frm_info,
                          global               void *frm_data,
+                         constant  struct Pst_Info *pst_info,
                          write_only      image2d_t  tex_data)
 {
-    if (has_work(frm_info)) tex_copy(frm_info, frm_data, tex_data);
+    if (has_output(frm_info))
+    {
+        int2 pixel = output_pixel(frm_info);
+        float3 color = get_color(frm_info, frm_data);
+        tex_write(frm_info, tex_data, post_process(pst_info, color, pixel));
+    }
 }
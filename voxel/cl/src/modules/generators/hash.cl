@@ -0,0 +1,38 @@
+/* OpenCL 1.2 --- modules/generators/hash.cl                   IMPLEMENTATION */
+
+#include <modules/generator.cl>
+
+/* A stateless generator, which hashes a 32-bit seed (folded from the instance *
+ * ID) with a counter, through the "lowbias32" integer hash by Chris Wellons. *
+ * It is the cheapest generator, at some cost in quality (and seeds collide  *
+ * much sooner than for the other generators).                               */
+
+static uint4 lowbias32(uint4 x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint fold(ulong x)
+{
+    return lowbias32((uint4)((uint)x ^ (uint)(x >> 32))).x;
+}
+
+struct PRNG prng_init(ulong4 instance_id)
+{
+    struct PRNG prng = {0, 0};
+    ulong frame = instance_id.z ^ fold(instance_id.w);
+    prng.key.x = fold(instance_id.x ^ fold(frame));
+    return prng;
+}
+
+uint4 generate(struct PRNG *prng)
+{
+    uint base = (uint)(prng->state.x++) * 4;
+    uint4 index = base + (uint4)(0, 1, 2, 3);
+    return lowbias32(lowbias32(index) ^ (uint)prng->key.x);
+}
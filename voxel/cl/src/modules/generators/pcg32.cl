@@ -0,0 +1,46 @@
+/* OpenCL 1.2 --- modules/generators/pcg32.cl                  IMPLEMENTATION */
+
+#include <modules/generator.cl>
+
+/* PCG32 (O'Neill, 2014), XSH-RR variant: a 64-bit LCG whose state is output *
+ * through a permutation, with one stream per instance. Only uses state.xy. */
+
+static ulong splitmix64(ulong x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    return x ^ (x >> 31);
+}
+
+static uint pcg_step(struct PRNG *prng)
+{
+    ulong old = prng->state.x;
+    prng->state.x = old * 6364136223846793005UL + prng->state.y;
+
+    uint xorshifted = (uint)(((old >> 18) ^ old) >> 27);
+    uint rot = (uint)(old >> 59);
+    return rotate(xorshifted, (32 - rot) & 31); // rotate right
+}
+
+struct PRNG prng_init(ulong4 instance_id)
+{
+    ulong seed = splitmix64(instance_id.x ^ splitmix64(instance_id.w));
+    ulong stream = splitmix64(instance_id.z ^ splitmix64(instance_id.y));
+
+    struct PRNG prng = {0, 0};
+    prng.state.y = (stream << 1) | 1; // the increment must be odd
+    pcg_step(&prng);
+    prng.state.x += seed;
+    pcg_step(&prng);
+    return prng;
+}
+
+uint4 generate(struct PRNG *prng)
+{
+    uint4 bits;
+    bits.x = pcg_step(prng);
+    bits.y = pcg_step(prng);
+    bits.z = pcg_step(prng);
+    bits.w = pcg_step(prng);
+    return bits;
+}
@@ -0,0 +1,43 @@
+/* OpenCL 1.2 --- modules/generators/philox.cl                 IMPLEMENTATION */
+
+#include <modules/generator.cl>
+
+/* Philox-4x32-7 (Salmon et al., 2011), a counter-based generator which only *
+ * needs 32-bit multiplies: the counter is state.xy and the key is key.x.   */
+
+#define PHILOX_M0 0xD2511F53
+#define PHILOX_M1 0xCD9E8D57
+#define PHILOX_W0 0x9E3779B9
+#define PHILOX_W1 0xBB67AE85
+#define PHILOX_ROUNDS 7
+
+static uint4 philox_round(uint4 c, uint2 k)
+{
+    uint hi0 = mul_hi((uint)PHILOX_M0, c.x), lo0 = PHILOX_M0 * c.x;
+    uint hi1 = mul_hi((uint)PHILOX_M1, c.z), lo1 = PHILOX_M1 * c.z;
+    return (uint4)(hi1 ^ c.y ^ k.x, lo1, hi0 ^ c.w ^ k.y, lo0);
+}
+
+struct PRNG prng_init(ulong4 instance_id)
+{
+    struct PRNG prng = {0, 0};
+    prng.state.y = instance_id.x; // the high half of the counter
+    prng.key.x = instance_id.z ^ (instance_id.w * 0x9E3779B97F4A7C15UL);
+    return prng;
+}
+
+uint4 generate(struct PRNG *prng)
+{
+    uint4 c = as_uint4(prng->state.lo);
+    uint2 k = as_uint2(prng->key.x);
+
+    #pragma unroll
+    for (size_t t = 0; t < PHILOX_ROUNDS; ++t)
+    {
+        c = philox_round(c, k);
+        k += (uint2)(PHILOX_W0, PHILOX_W1);
+    }
+
+    prng->state.x += 1; // next block
+    return c;
+}
@@ -0,0 +1,49 @@
+/* OpenCL 1.2 --- modules/generators/threefish.cl              IMPLEMENTATION */
+
+#include <modules/generator.cl>
+
+/* A variation of Threefish-256, with the instance ID as the key: this is of *
+ * very high quality but needs 64-bit integer arithmetic, 32 rounds a call. */
+static void renew(ulong4 *state, ulong4 seed)
+{
+    ulong4 block = *state + seed;
+
+    #pragma unroll
+    for (size_t t = 0; t < 4; t++)
+    {
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(14, 16));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(52, 57));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(23, 40));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)( 5, 37));
+        block.hi ^= block.lo; block = block.xywz;
+
+        block += seed;
+
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(25, 33));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(46, 12));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(58, 22));
+        block.hi ^= block.lo; block = block.xywz;
+        block.lo += block.hi; block.hi = rotate(block.hi, (ulong2)(32, 32));
+        block.hi ^= block.lo; block = block.xywz;
+
+        block += seed;
+    }
+
+    *state ^= block;
+}
+
+struct PRNG prng_init(ulong4 instance_id)
+{
+    return (struct PRNG){0, instance_id};
+}
+
+uint4 generate(struct PRNG *prng)
+{
+    renew(&prng->state, prng->key);
+    return convert_uint4(prng->state >> 32);
+}
@@ -2,15 +2,15 @@
 
 #include <modules/integrator.cl>
 
-float3 integrate(struct Ray ray, global struct Geometry *geometry,
-                 struct PRNG *prng)
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler)
 {
-    float distance;
-    struct Hit_Info hit;
-
-    if (intersects(geometry, ray, INFINITY, &distance, &hit))
+    if (hit)
     {
-        advance(&ray, distance, transform(cosine(prng), hit.basis));
+        float3 direction = cosine_warp(sample2(sampler));
+        advance(&ray, distance, transform(direction, hit->basis));
         if (!occludes(geometry, ray, INFINITY)) return C_WHITE;
     }
 
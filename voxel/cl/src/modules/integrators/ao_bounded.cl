@@ -0,0 +1,39 @@
+/* OpenCL 1.2 --- modules/integrators/ao_bounded.cl            IMPLEMENTATION */
+
+#include <modules/integrator.cl>
+
+/* These are normally defined when acquiring this integrator, see the header *
+ * `modules/integrators.hpp` (AO_RANGE is in world units, e.g. 0.25f).       */
+#ifndef AO_RAYS
+#define AO_RAYS 4
+#endif
+
+#ifndef AO_RANGE
+#define AO_RANGE 0.25f
+#endif
+
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler)
+{
+    if (hit)
+    {
+        /* All rays share the primary hit, and are jointly stratified. */
+        uint visible = 0;
+        advance(&ray, distance, ray.d);
+
+        for (uint k = 0; k < AO_RAYS; ++k)
+        {
+            struct Sampler batch = sampler_batch(sampler, AO_RAYS, k);
+            float3 direction = cosine_warp(sample2(&batch));
+            struct Ray occlusion = {ray.o, transform(direction, hit->basis)};
+
+            if (!occludes(geometry, occlusion, AO_RANGE)) ++visible;
+        }
+
+        return C_WHITE * ((float)visible / AO_RAYS);
+    }
+
+    return C_BLACK;
+}
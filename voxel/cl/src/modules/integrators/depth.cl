@@ -2,14 +2,14 @@
 
 #include <modules/integrator.cl>
 
-float3 integrate(struct Ray ray, global struct Geometry *geometry,
-                 struct PRNG *prng)
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler)
 {
-    float depth;
-
-    if (intersects(geometry, ray, INFINITY, &depth, 0))
+    if (hit)
     {
-        return (float3)(0.25, 0.75, 0.25) * (0.5f - depth / 3);
+        return (float3)(0.25, 0.75, 0.25) * (0.5f - distance / 3);
     }
 
     return C_BLACK;
@@ -2,15 +2,14 @@
 
 #include <modules/integrator.cl>
 
-float3 integrate(struct Ray ray, global struct Geometry *geometry,
-                 struct PRNG *prng)
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler)
 {
-    float depth;
-    struct Hit_Info hit;
-
-    if (intersects(geometry, ray, INFINITY, &depth, &hit))
+    if (hit)
     {
-        return (hit.basis.n * 0.5f + 0.5f) * (0.5f - depth / 3);
+        return (hit->basis.n * 0.5f + 0.5f) * (0.5f - distance / 3);
     }
 
     return C_BLACK;
@@ -0,0 +1,83 @@
+/* OpenCL 1.2 --- modules/integrators/path.cl                  IMPLEMENTATION */
+
+#include <modules/integrator.cl>
+
+/* The lighting is a sun (a directional light, given by the direction towards *
+ * it and its irradiance) over a sky of constant color above the horizon.    */
+#define SUN_DIRECTION ((float3)(0.36f, 0.80f, 0.48f))
+#define SUN_IRRADIANCE ((float3)(3.2f, 3.0f, 2.7f))
+#define SKY_ZENITH ((float3)(0.25f, 0.45f, 0.90f))
+#define SKY_HORIZON ((float3)(0.75f, 0.85f, 0.95f))
+#define GROUND ((float3)(0.20f, 0.18f, 0.16f))
+
+/* Paths are cut off after MAX_BOUNCES, and Russian roulette starts to prune *
+ * them after RR_BOUNCES (its survival probability is capped below one).     */
+#define MAX_BOUNCES 8
+#define RR_BOUNCES 2
+#define RR_MAX_SURVIVAL 0.95f
+
+static float3 sky(float3 direction)
+{
+    if (direction.y < 0) return GROUND;
+    return mix(SKY_HORIZON, SKY_ZENITH, direction.y);
+}
+
+/* This is the sun's contribution at a diffuse surface (next-event estimation *
+ * towards it), which only needs one shadow ray as the sun is a delta light. */
+static float3 direct(global struct Geometry *geometry, float3 point, float3 n)
+{
+    float NdL = dot(n, SUN_DIRECTION);
+    if (NdL <= 0) return C_BLACK;
+
+    struct Ray shadow = {point, SUN_DIRECTION};
+    if (occludes(geometry, shadow, INFINITY)) return C_BLACK;
+
+    return SUN_IRRADIANCE * (NdL * M_1_PI_F);
+}
+
+float3 integrate(struct Ray ray, float distance, struct Hit_Info *hit,
+                 global struct Geometry *geometry,
+                 constant struct Mtl_Table *materials,
+                 struct PRNG *prng, struct Sampler *sampler)
+{
+    if (!hit) return sky(ray.d);
+
+    float3 radiance = C_BLACK, throughput = C_WHITE;
+    struct Hit_Info info = *hit;
+
+    for (uint bounce = 0; ; ++bounce)
+    {
+        struct Material material = get_material(materials, info.material);
+        float3 albedo = material.albedo;
+        advance(&ray, distance, ray.d);
+
+        radiance += throughput * material.emission;
+        radiance += throughput * albedo * direct(geometry, ray.o, info.basis.n);
+
+        if (bounce == MAX_BOUNCES) break;
+
+        /* Cosine-weighted sampling cancels out the diffuse BRDF's cosine and *
+         * its 1/pi factor, leaving the albedo as the path throughput weight. */
+        throughput *= albedo;
+
+        if (bounce >= RR_BOUNCES)
+        {
+            float survival = max(max(throughput.x, throughput.y), throughput.z);
+            survival = min(survival, RR_MAX_SURVIVAL);
+
+            if (rand(prng) >= survival) break;
+            throughput /= survival;
+        }
+
+        float3 direction = cosine_warp(sample2(sampler));
+        ray.d = transform(direction, info.basis);
+
+        if (!intersects(geometry, ray, INFINITY, &distance, &info))
+        {
+            radiance += throughput * sky(ray.d);
+            break;
+        }
+    }
+
+    return radiance;
+}
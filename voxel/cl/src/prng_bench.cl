@@ -0,0 +1,81 @@
+/* OpenCL 1.2 --- prng_bench.cl                                IMPLEMENTATION */
+
+/** @file prng_bench.cl
+  *
+  * @brief PRNG Benchmark
+  *
+  * Contains kernels to measure the throughput of the linked generator module,
+  * and to gather some basic statistics about its output (its moments, serial
+  * correlation, bit balance and distribution) to check it for gross defects.
+  *
+  * @remarks These are linked separately from the renderer's kernels.
+**/
+
+#include <core/prng_lib.cl>
+#include <modules/generator.cl>
+
+/* The number of buckets of the distribution histogram (a power of two). */
+#define BINS 16
+
+/** Generates numbers as fast as possible, only combining them so that the
+  * generator is not optimized away.
+  *
+  * @param sink    One value per work item, to be ignored.
+  * @param items   The number of work items.
+  * @param rounds  The number of calls to \c generate() per work item.
+  * @param seed    The seed, to vary between runs.
+**/
+kernel void prng_speed(global uint4 *sink, uint items, uint rounds, ulong seed)
+{
+    if (get_global_id(0) >= items) return;
+
+    struct PRNG prng = prng_init((ulong4)(get_global_id(0), 0, seed, 1));
+    uint4 acc = 0;
+
+    for (uint t = 0; t < rounds; ++t) acc ^= generate(&prng);
+
+    sink[get_global_id(0)] = acc;
+}
+
+/** Gathers statistics over the numbers generated by each work item.
+  *
+  * @param moments  The sums of x, x^2 and x_i * x_{i-1} (with x in [0, 1)).
+  * @param counts   The histogram (BINS buckets) and number of one bits.
+  * @param items    The number of work items.
+  * @param rounds   The number of calls to \c generate() per work item.
+  * @param seed     The seed, to vary between runs.
+**/
+kernel void prng_stats(global float4 *moments, global uint *counts,
+                       uint items, uint rounds, ulong seed)
+{
+    if (get_global_id(0) >= items) return;
+
+    struct PRNG prng = prng_init((ulong4)(get_global_id(0), 0, seed, 1));
+    uint bins[BINS] = {0}, ones = 0;
+    float4 sum = 0;
+    float prev = 0;
+
+    for (uint t = 0; t < rounds; ++t)
+    {
+        uint4 bits = generate(&prng);
+        uint4 bit_counts = popcount(bits);
+        ones += bit_counts.x + bit_counts.y + bit_counts.z + bit_counts.w;
+
+        uint values[4] = {bits.x, bits.y, bits.z, bits.w};
+
+        for (size_t u = 0; u < 4; ++u)
+        {
+            float x = (values[u] >> 8) * (1.0f / 16777216);
+            sum += (float4)(x, x * x, x * prev, 0);
+            bins[values[u] / (0xFFFFFFFFU / BINS + 1)]++;
+            prev = x;
+        }
+    }
+
+    moments[get_global_id(0)] = sum;
+
+    for (size_t t = 0; t < BINS; ++t)
+        counts[get_global_id(0) * (BINS + 1) + t] = bins[t];
+
+    counts[get_global_id(0) * (BINS + 1) + BINS] = ones;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+/** @file builder.hpp
+  *
+  * @brief External-Memory Octree Builder
+  *
+  * Builds the chunked page file of a world from individual voxels, which can
+  * be far more numerous than would fit in memory. Voxels are keyed by chunk,
+  * then by their Morton code within the chunk (which orders them as a depth-
+  * first walk of the octree would), and buffered in memory, with full buffers
+  * sorted and spilled to disk as runs. The runs are then merged and each chunk
+  * is built bottom-up from its voxels in Morton order, which only ever needs a
+  * partially filled node per level, before being paged out (see pages.hpp).
+  *
+  * Memory use is thus bounded by the buffer size and by the largest chunk.
+**/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "geometry/pages.hpp"
+
+/** @class SVOBuilder
+  *
+  * Collects the voxels of a world and then writes its page file.
+**/
+class SVOBuilder
+{
+    public:
+        /** The default memory budget for buffered voxels, in bytes.
+        **/
+        static const std::size_t DEFAULT_MEMORY = 256 << 20;
+
+        /** The maximum depth of the chunks' octrees, which is the deepest the
+          * kernel's traversal stack allows (\c MAX_CHUNK_LEVELS).
+        **/
+        static const uint32_t MAX_DEPTH = 8;
+
+        /** The material of a hidden voxel, which is enclosed by solid voxels
+          * and so can never be seen. Hidden voxels are made solid where that
+          * lets their node merge into a leaf, and are left empty otherwise.
+        **/
+        static const uint16_t HIDDEN = 0x8000;
+
+        /** Starts building a world.
+          *
+          * @param width    The width of the chunk grid (in cells).
+          * @param height   The height of the chunk grid (in cells).
+          * @param depth    The depth of the chunk grid (in cells).
+          * @param levels   The depth of each chunk's octree, such that each
+          *                 chunk is \c 2^levels voxels across.
+          * @param scratch  A path prefix for the temporary run files.
+          * @param memory   The memory budget for buffered voxels, in bytes.
+        **/
+        SVOBuilder(uint32_t width, uint32_t height, uint32_t depth,
+                   uint32_t levels, const std::string &scratch,
+                   std::size_t memory = DEFAULT_MEMORY);
+
+        ~SVOBuilder(); // removes any run files
+
+        SVOBuilder(const SVOBuilder &) = delete;
+        SVOBuilder &operator=(const SVOBuilder &) = delete;
+
+        uint32_t grid_width(void) const;
+        uint32_t grid_height(void) const;
+        uint32_t grid_depth(void) const;
+
+        /** Returns the number of voxels across each chunk.
+        **/
+        uint32_t resolution(void) const;
+
+        /** Adds a voxel (if a voxel is added more than once, only one of its
+          * materials is kept).
+          *
+          * @param x         The x-coordinate, in voxels from the world's min
+          *                  corner (which is the min corner of the grid).
+          * @param y         The y-coordinate, likewise.
+          * @param z         The z-coordinate, likewise.
+          * @param material  The voxel's 15-bit material ID, or \c HIDDEN.
+        **/
+        void add(uint32_t x, uint32_t y, uint32_t z, uint16_t material);
+
+        /** Returns the number of voxels added so far.
+        **/
+        std::size_t count(void) const;
+
+        /** Builds the octree of each chunk holding any voxels, and writes the
+          * world to a page file (this may only be done once).
+          *
+          * @param path        The path of the page file to write.
+          * @param page_nodes  The number of nodes per page.
+          *
+          * @return The number of pages written.
+        **/
+        std::size_t build(const std::string &path, std::size_t page_nodes);
+
+    private:
+        struct Record
+        {
+            uint64_t key; // the cell, then the Morton code in the chunk
+            uint32_t material, run; // the run it was read from, if merging
+
+            bool operator <(const Record &other) const
+            {
+                return key < other.key;
+            }
+        };
+
+        uint32_t size[3], levels;
+        std::string scratch;
+        std::size_t capacity, added;
+        std::vector<Record> buffer;
+        std::vector<std::string> runs;
+
+        void spill(void);
+};
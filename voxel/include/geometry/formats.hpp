@@ -0,0 +1,26 @@
+#pragma once
+
+/** @file formats.hpp
+  *
+  * @brief Geometry File Formats
+  *
+  * The importers pick the format of a file from its extension, which this unit
+  * recognizes for all of them alike.
+**/
+
+#include <algorithm>
+#include <string>
+#include <cctype>
+
+/** Returns whether a path ends with an extension, ignoring case.
+  *
+  * @param path  The path of the file.
+  * @param ext   The extension, including the dot (e.g. ".obj"), in lowercase.
+**/
+inline bool has_extension(const std::string &path, const std::string &ext)
+{
+    if (path.size() < ext.size()) return false;
+
+    return std::equal(ext.rbegin(), ext.rend(), path.rbegin(),
+                      [](char a, char b) { return a == tolower(b); });
+}
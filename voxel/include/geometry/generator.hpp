@@ -0,0 +1,125 @@
+#pragma once
+
+/** @file generator.hpp
+  *
+  * @brief Procedural Geometry Generators
+  *
+  * A generator describes a solid procedurally, and can tell (conservatively)
+  * whether a box is entirely empty, entirely solid, or may contain some of the
+  * solid's surface. Octrees are then built top-down, only subdividing the boxes
+  * which may contain surface, with empty boxes pruned and solid boxes becoming
+  * a single leaf, so that generation cost scales with the surface area of the
+  * solid rather than with its volume. Boxes which may contain surface at the
+  * deepest level become leaves if their center lies inside the solid.
+  *
+  * Heightfields and signed distance functions are provided, both bounded with
+  * Lipschitz constants (a bound on how fast the function may change), though
+  * any generator able to bound its function over a box (e.g. using interval
+  * arithmetic) may be implemented.
+**/
+
+#include <functional>
+#include <cstdint>
+#include <vector>
+
+#include "math/vector3.hpp"
+#include "geometry/aabb.hpp"
+#include "geometry/svo.hpp"
+
+class Generator
+{
+    public:
+        enum class Region
+        {
+            EMPTY,   // the box is entirely outside of the solid
+            SOLID,   // the box is entirely inside of the solid
+            SURFACE, // the box may contain some of the surface
+        };
+
+        /** Creates a generator for a solid made of a single material.
+        **/
+        explicit Generator(uint16_t material);
+
+        virtual ~Generator() { }
+
+        /** Classifies a box, which may only be found to be empty or solid if
+          * it is entirely so.
+        **/
+        virtual Region classify(const aabb &box) const = 0;
+
+        /** Returns whether a point is inside of the solid.
+        **/
+        virtual bool inside(const math::float3 &point) const = 0;
+
+        /** Builds the octree of the solid within a cube.
+          *
+          * @param cube    The cube (which the octree's root spans).
+          * @param levels  The depth of the octree.
+          *
+          * @return The nodes, the root being the first node, or no nodes at
+          *         all if the cube is empty.
+        **/
+        std::vector<Node> build(const aabb &cube, uint32_t levels) const;
+
+    private:
+        uint16_t material;
+
+        uint32_t subtree(std::vector<Node> &nodes, const aabb &cube,
+                         uint32_t levels) const;
+};
+
+/** @class HeightfieldGenerator
+  *
+  * A terrain, solid below the height given at each point of the xz-plane. The
+  * height's rate of change along each axis must be bounded.
+**/
+class HeightfieldGenerator : public Generator
+{
+    public:
+        typedef std::function<float(float x, float z)> Height;
+
+        /** Creates a heightfield.
+          *
+          * @param height    The height function.
+          * @param slope_x   A bound on the height's derivative along x.
+          * @param slope_z   A bound on the height's derivative along z.
+          * @param material  The terrain's material ID.
+        **/
+        HeightfieldGenerator(const Height &height, float slope_x,
+                             float slope_z, uint16_t material);
+
+        Region classify(const aabb &box) const override;
+        bool inside(const math::float3 &point) const override;
+
+    private:
+        Height height;
+        float slope_x, slope_z;
+};
+
+/** @class SDFGenerator
+  *
+  * A solid where a signed distance function is negative. The function needs
+  * not give the exact distance, as long as its rate of change is bounded (an
+  * exact distance function changing by at most one per unit of distance).
+**/
+class SDFGenerator : public Generator
+{
+    public:
+        typedef std::function<float(const math::float3 &point)> Distance;
+
+        /** Creates a solid from a signed distance function.
+          *
+          * @param distance   The signed distance function.
+          * @param lipschitz  A bound on the function's rate of change.
+          * @param material   The solid's material ID.
+        **/
+        SDFGenerator(const Distance &distance, float lipschitz,
+                     uint16_t material);
+
+        Region classify(const aabb &box) const override;
+        bool inside(const math::float3 &point) const override;
+
+    private:
+        Distance distance;
+        float lipschitz;
+};
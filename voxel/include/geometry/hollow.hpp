@@ -0,0 +1,52 @@
+#pragma once
+
+/** @file hollow.hpp
+  *
+  * @brief Interior Voxel Detection
+  *
+  * A voxel whose six neighbours are all solid can never be seen (any ray to it
+  * would first hit one of its neighbours), so such interior voxels are marked
+  * as hidden before building octrees. The builder is then free to fill them or
+  * leave them empty, whichever takes fewer nodes (so that interiors of mixed
+  * materials merge into single leaves, just as uniform interiors do).
+  *
+  * Occupancy is stored a slab (fixed z) at a time, as rows along x of 64-bit
+  * words, each holding 64 voxels. The neighbours along x are then found with
+  * shifts (carrying a bit across from adjacent words), and those along y and z
+  * are the words at the same position in adjacent rows and slabs, so that each
+  * word of 64 voxels only takes a few shifts and ANDs.
+**/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "setup/thread_pool.hpp"
+
+/** @namespace hollow
+  *
+  * @brief Namespace for interior voxel detection
+**/
+namespace hollow
+{
+    /** Returns the number of words in each row of a slab (any bits past the
+      * end of the row must be zero).
+      *
+      * @param width  The number of voxels in each row.
+    **/
+    std::size_t row_words(uint32_t width);
+
+    /** Finds the exposed voxels of a slab, which are the solid voxels with at
+      * least one empty neighbour (everything outside of the volume is empty).
+      *
+      * @param below    The occupancy of the slab below, or \c nullptr.
+      * @param slab     The occupancy of the slab.
+      * @param above    The occupancy of the slab above, or \c nullptr.
+      * @param exposed  The exposed voxels of the slab.
+      * @param width    The number of voxels in each row.
+      * @param height   The number of rows.
+      * @param pool     The thread pool to process blocks of rows on.
+    **/
+    void exposed(const uint64_t *below, const uint64_t *slab,
+                 const uint64_t *above, uint64_t *exposed, uint32_t width,
+                 uint32_t height, ThreadPool &pool);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+/** @file importer.hpp
+  *
+  * @brief World Importer
+  *
+  * Converts a triangle mesh (see mesh.hpp) into a world, at a given depth, the
+  * mesh being uniformly scaled such that its longest side is \c 2^depth voxels
+  * across. Volumes (see volume.hpp) are instead imported one voxel per voxel,
+  * and so need to be at most \c 2^depth voxels across. The chunk grid is sized
+  * to fit the voxels, every chunk being \c 2^CHUNK_LEVELS voxels across (or
+  * less, for shallow worlds). The interior voxels of volumes are hidden, as
+  * they can never be seen (meshes only ever give surface voxels anyway).
+**/
+
+#include <cstdint>
+#include <string>
+
+/** @namespace importer
+  *
+  * @brief Namespace for the world importer
+**/
+namespace importer
+{
+    /** The depth of each chunk's octree (at most \c SVOBuilder::MAX_DEPTH,
+      * which the kernel's traversal stack is sized for).
+    **/
+    static const uint32_t CHUNK_LEVELS = 8;
+
+    /** The maximum depth of a world (beyond which the chunk grid would get
+      * too large to stream).
+    **/
+    static const uint32_t MAX_DEPTH = 16;
+
+    /** Imports a file into a world.
+      *
+      * @param source           The file to import (a mesh or a volume, going
+      *                         by the file's extension).
+      * @param depth            The depth of the world (see above).
+      * @param path             The path of the world's page file to write.
+      * @param hide_interior    Whether to hide interior voxels (see the
+      *                         \c SVOBuilder::HIDDEN material).
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool run(const std::string &source, uint32_t depth,
+             const std::string &path, bool hide_interior = true);
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+/** @file mesh.hpp
+  *
+  * @brief Triangle Meshes
+  *
+  * Loads triangle meshes to be voxelized (see voxelizer.hpp) from Wavefront OBJ
+  * files, and from ASCII or binary PLY files. Polygons are split into triangle
+  * fans, and each triangle gets the material ID of the mesh material it uses,
+  * which is one plus the index of that material's name (zero meaning none).
+  *
+  * An OBJ file's materials are those named by its \c usemtl statements, while
+  * a PLY file's faces may have a \c material_index property (the materials
+  * then being named after their index).
+**/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "math/vector3.hpp"
+#include "geometry/aabb.hpp"
+
+class Mesh
+{
+    public:
+        /** The maximum number of materials, such that every material ID fits
+          * in a leaf (see svo.hpp).
+        **/
+        static const std::size_t MAX_MATERIALS = 0x7FFF;
+
+        struct Triangle
+        {
+            uint32_t vertex[3];
+            uint16_t material;
+        };
+
+        /** Loads a mesh, in the format given by the file's extension.
+          *
+          * @param path  The path of the mesh file (\c .obj or \c .ply).
+        **/
+        explicit Mesh(const std::string &path);
+
+        const std::vector<math::float3> &vertices(void) const;
+        const std::vector<Triangle> &triangles(void) const;
+
+        /** Returns the names of the materials, the material with ID \c n being
+          * at index <tt>n - 1</tt>.
+        **/
+        const std::vector<std::string> &materials(void) const;
+
+        /** Returns the bounding box of the vertices used by any triangle.
+        **/
+        aabb bounds(void) const;
+
+    private:
+        std::vector<math::float3> vertex_list;
+        std::vector<Triangle> triangle_list;
+        std::vector<std::string> material_list;
+
+        void load_obj(const std::string &path);
+        void load_ply(const std::string &path);
+        void add_polygon(const std::vector<uint32_t> &polygon,
+                         uint32_t material);
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+/** @file pages.hpp
+  *
+  * @brief Paged Sparse Voxel Octrees
+  *
+  * A paged tree is split into subtrees which are stored in fixed-size pages of
+  * nodes, so that they can be individually streamed in from disk. Pointers to
+  * nodes within the same page hold the node's index in that page, while those
+  * to a node in another page instead are page references, holding the page ID
+  * along with \c PAGE_FLAG. A page may hold several subtrees, as long as they
+  * are all children of the same node, so that small sibling subtrees can share
+  * a page rather than each taking up a page of their own.
+  *
+  * A page file holds a world made up of a grid of chunks, each of which has its
+  * own tree, starting in its own root page. It consists of a header (with the
+  * dimensions of the grid), then the pages and finally an index giving, for
+  * each page, the node in the parent page that points into it (along with the
+  * node each of its children points to in the page), and a cube bounding the
+  * page's subtrees (so pages can be selected by location), as well as the root
+  * page of each cell of the grid.
+  *
+  * Pages are compressed independently of one another (so that they can still
+  * be read individually, and decompressed in parallel), with a simple codec in
+  * which the child pointers are delta-encoded (see \c pages.cpp), as the index
+  * also gives the offset and size of each page in the file.
+**/
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "geometry/svo.hpp"
+
+class PageFile
+{
+    public:
+        /** @struct PageInfo
+          *
+          * Locates the node referring to a page (in its parent page), whose
+          * children point to the first nodes of the page's subtrees, and the
+          * cube bounding the subtrees, as integer coordinates on the grid of
+          * cubes at its level within its tree (the root cube being at level
+          * zero). The root page of a tree only holds the subtree of its root,
+          * starting at its first node.
+        **/
+        struct PageInfo
+        {
+            uint32_t parent; // NO_PAGE for root pages
+            uint32_t node;
+            uint32_t tree; // the ID of the tree's root page
+            uint32_t level, x, y, z;
+            uint32_t entry[8]; // per child of the node, or NO_ENTRY
+        };
+
+        static const uint32_t NO_PAGE = 0xFFFFFFFF;
+        static const uint32_t NO_ENTRY = 0xFFFFFFFF;
+
+        class Writer; // see below
+
+        /** Opens a page file and reads its index.
+          *
+          * @param path  The path of the page file.
+        **/
+        explicit PageFile(const std::string &path);
+
+        std::size_t page_nodes(void) const;
+        std::size_t page_count(void) const;
+
+        uint32_t grid_width(void) const;
+        uint32_t grid_height(void) const;
+        uint32_t grid_depth(void) const;
+
+        /** Returns the root page of a cell's chunk, or \c NO_PAGE if empty.
+        **/
+        uint32_t chunk(uint32_t cell) const;
+
+        const PageInfo &info(uint32_t page) const;
+
+        /** Reads a page from the file, as it is stored (compressed).
+          *
+          * @param page  The page ID.
+          * @param data  The compressed page (resized to fit).
+        **/
+        void read(uint32_t page, std::vector<uint8_t> &data);
+
+        /** Decompresses a page read from the file (this may be called from any
+          * thread, even while the file is being read from).
+          *
+          * @param data   The compressed page.
+          * @param nodes  The page's nodes (\c page_nodes() of them).
+          *
+          * @return The number of nodes in use, which come first (the others
+          *         being empty).
+        **/
+        std::size_t decode(const std::vector<uint8_t> &data,
+                           Node *nodes) const;
+
+    private:
+        struct Header
+        {
+            char magic[8];
+            uint32_t page_nodes, page_count;
+            uint32_t grid[3], padding;
+            uint64_t index_offset;
+        } __attribute__((packed));
+
+        struct Extent
+        {
+            uint64_t offset;
+            uint32_t size, padding;
+        };
+
+        std::ifstream file;
+        Header header;
+        std::vector<PageInfo> index;
+        std::vector<Extent> extents;
+        std::vector<uint32_t> cells; // root page of each
+};
+
+/** @class PageFile::Writer
+  *
+  * Writes a page file one tree at a time, so that only a single tree needs to
+  * be held in memory at once.
+**/
+class PageFile::Writer
+{
+    public:
+        /** Creates the page file, with every cell of the grid empty.
+          *
+          * @param path        The path of the page file to write.
+          * @param page_nodes  The number of nodes per page.
+          * @param width       The width of the grid (in cells).
+          * @param height      The height of the grid (in cells).
+          * @param depth       The depth of the grid (in cells).
+        **/
+        Writer(const std::string &path, std::size_t page_nodes,
+               uint32_t width, uint32_t height, uint32_t depth);
+
+        /** Splits a tree into pages and writes them, as the chunk of a cell.
+          * Subtrees are only cut off (bottom-up, the largest first) where the
+          * page of their parent could not fit them, and the subtrees cut off
+          * from each node are then packed into as few pages as will fit them.
+          *
+          * @param cell   The cell (see \c ChunkGrid::cell()).
+          * @param nodes  The nodes of the tree.
+          * @param root   The index of the root node.
+          *
+          * @return The ID of the tree's root page.
+        **/
+        uint32_t add(uint32_t cell, const std::vector<Node> &nodes,
+                     uint32_t root);
+
+        /** Writes the index, completing the page file.
+          *
+          * @return The number of pages written.
+        **/
+        std::size_t finish(void);
+
+    private:
+        std::ofstream file;
+        Header header;
+        std::vector<PageInfo> index;
+        std::vector<Extent> extents;
+        std::vector<uint32_t> cells;
+        std::vector<uint8_t> data;
+};
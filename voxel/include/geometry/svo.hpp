@@ -0,0 +1,34 @@
+#pragma once
+
+/** @file svo.hpp
+  *
+  * @brief Sparse Voxel Octree Nodes
+  *
+  * Each node has eight 32-bit child pointers, which are either zero (an empty
+  * octant), a leaf (with the top bit set, and a 15-bit material ID above the
+  * low 16 bits), the index of another node, or a reference to a page of nodes
+  * which is not resident (with the second highest bit set, see `pages.hpp`).
+**/
+
+#include <cstdint>
+
+struct Node
+{
+    uint32_t child[8];
+};
+
+static const uint32_t LEAF_FLAG = 0x80000000;
+static const uint32_t PAGE_FLAG = 0x40000000;
+
+inline uint32_t encode_leaf(const uint16_t &material)
+{
+    return (((material & 0x7FFF) << 16)) | LEAF_FLAG;
+}
+
+/** Returns whether a child pointer refers to a node (rather than being empty,
+  * a leaf, or a reference to a page).
+**/
+inline bool is_node(uint32_t child)
+{
+    return (child != 0) && !(child & (LEAF_FLAG | PAGE_FLAG));
+}
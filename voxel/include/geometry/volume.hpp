@@ -0,0 +1,102 @@
+#pragma once
+
+/** @file volume.hpp
+  *
+  * @brief Voxel Volumes
+  *
+  * Reads voxel volumes to be imported one voxel per voxel, streaming them into
+  * an octree builder a slab at a time (so that memory use is proportional to
+  * a slab, rather than to the entire volume). Interior voxels are hidden on
+  * the way by default (see hollow.hpp), which needs the occupancy of the whole
+  * volume for .vox files, at one bit per voxel, as their voxels are unordered.
+  * Two formats are supported:
+  *
+  * - Raw volumes of 8-bit or 16-bit (little-endian) values, stored with x
+  *   varying the fastest and z the slowest, whose dimensions are given by the
+  *   file name (as in \c bonsai_256x256x256_uint8.raw), the value size then
+  *   following from the file size. Zero values are empty, and other values
+  *   are taken as the material ID (so density volumes should be thresholded
+  *   beforehand).
+  *
+  * - MagicaVoxel \c .vox files, whose models are placed by the translations
+  *   in the scene graph (if any), and whose voxels get the index of their
+  *   palette entry as material ID. The z-axis is up in such files, and so it
+  *   becomes the y-axis (with the y-axis becoming the z-axis, reversed).
+**/
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "geometry/builder.hpp"
+#include "setup/thread_pool.hpp"
+
+class Volume
+{
+    public:
+        /** Opens a volume and reads its dimensions, in the format given by the
+          * file's extension.
+          *
+          * @param path  The path of the volume file (\c .raw or \c .vox).
+        **/
+        explicit Volume(const std::string &path);
+
+        /** Returns whether a file is a volume, going by its extension.
+        **/
+        static bool supports(const std::string &path);
+
+        uint32_t width(void) const;
+        uint32_t height(void) const;
+        uint32_t depth(void) const;
+
+        /** Adds every voxel of the volume to a builder, the volume's min corner
+          * being at the world's min corner (this may only be done once).
+          *
+          * @param builder          The builder.
+          * @param pool             The thread pool to find hidden voxels on.
+          * @param hide_interior    Whether to add interior voxels as hidden.
+          *
+          * @return The number of voxels added.
+        **/
+        std::size_t stream(SVOBuilder &builder, ThreadPool &pool,
+                           bool hide_interior = true);
+
+    private:
+        /* A model of a .vox file, which is a list of voxels. */
+        struct Model
+        {
+            uint64_t offset; // of the first voxel
+            uint32_t count;
+        };
+
+        /* A placement of a model within the volume (the volume's min corner *
+         * being at the origin), in the coordinates of the .vox file.       */
+        struct Instance
+        {
+            uint32_t model;
+            int32_t min[3];
+        };
+
+        std::string path;
+        std::ifstream file;
+        uint32_t size[3];
+        std::size_t value_bytes; // of raw volumes, zero for .vox files
+        std::vector<Model> models;
+        std::vector<Instance> instances;
+
+        void open_raw(void);
+        void open_vox(void);
+        std::size_t stream_raw(SVOBuilder &builder, ThreadPool &pool,
+                               bool hide_interior);
+        std::size_t stream_vox(SVOBuilder &builder, ThreadPool &pool,
+                               bool hide_interior);
+
+        /* Reads every voxel of a .vox file (in the volume's coordinates), *
+         * throwing if any lies outside of the volume.                       */
+        void read_vox(const std::function<void(uint32_t x, uint32_t y,
+                                               uint32_t z, uint16_t material)>
+                      &voxel);
+};
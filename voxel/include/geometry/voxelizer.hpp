@@ -0,0 +1,55 @@
+#pragma once
+
+/** @file voxelizer.hpp
+  *
+  * @brief Parallel Mesh Voxelizer
+  *
+  * Voxelizes the surface of a triangle mesh into an octree builder. Triangles
+  * are first binned into the cubic tiles of voxels their bounding boxes touch,
+  * and then the tiles are voxelized in parallel, each voxel in the bounding box
+  * of a triangle being added if the triangle overlaps it. The overlap test is
+  * conservative (it finds every voxel the triangle touches, even on a face or
+  * an edge), and uses the separating axis theorem, which only needs the axes
+  * of the box, the triangle's normal and their pairwise cross products.
+  *
+  * Each tile adds its voxels all at once (without duplicates), so that the
+  * builder needs little synchronization and no more memory than necessary.
+**/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "math/vector3.hpp"
+#include "geometry/builder.hpp"
+#include "geometry/mesh.hpp"
+#include "setup/thread_pool.hpp"
+
+/** @namespace voxelizer
+  *
+  * @brief Namespace for the mesh voxelizer
+**/
+namespace voxelizer
+{
+    /** The minimum number of voxels across each tile.
+    **/
+    static const uint32_t TILE_SIZE = 32;
+
+    /** The maximum number of tiles along each axis (tiles are made larger
+      * than \c TILE_SIZE where needed, to bound the binning memory).
+    **/
+    static const uint32_t MAX_TILES = 128;
+
+    /** Adds every voxel overlapped by a triangle of the mesh, with the
+      * material ID of one of the triangles overlapping it, to a builder.
+      *
+      * @param mesh     The mesh.
+      * @param origin   The point mapped to the min corner of the world.
+      * @param scale    The number of voxels per unit of mesh space.
+      * @param builder  The builder (only voxels within its grid are added).
+      * @param pool     The thread pool to voxelize the tiles on.
+      *
+      * @return The number of voxels added.
+    **/
+    std::size_t run(const Mesh &mesh, const math::float3 &origin,
+                    float scale, SVOBuilder &builder, ThreadPool &pool);
+};
@@ -29,6 +29,14 @@ namespace atb
     **/
     TwType integrators(void);
 
+    /** The variable type enumerating PRNG generators.
+    **/
+    TwType generators(void);
+
+    /** The variable type enumerating tonemapping operators.
+    **/
+    TwType tonemappers(void);
+
     /** Initializes the AntTweakBar library and creates one bar.
       *
       * @param bar_title  Title of the bar.
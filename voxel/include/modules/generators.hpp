@@ -0,0 +1,94 @@
+#pragma once
+
+/** @file modules/generators.hpp
+  *
+  * @brief Generator Modules
+  *
+  * Provides access to the PRNG generators.
+**/
+
+#include <CL/cl.hpp>
+#include <stdexcept>
+
+#include "setup/scheduler.hpp"
+
+/** @namespace generators
+  *
+  * @brief Namespace for the generators
+  *
+  * @see include/modules/generator.cl
+**/
+namespace generators
+{
+    inline cl::Program threefish(void)
+    {
+        return scheduler::acquire("modules/generators/threefish");
+    }
+
+    inline cl::Program pcg32(void)
+    {
+        return scheduler::acquire("modules/generators/pcg32");
+    }
+
+    inline cl::Program philox(void)
+    {
+        return scheduler::acquire("modules/generators/philox");
+    }
+
+    inline cl::Program hash(void)
+    {
+        return scheduler::acquire("modules/generators/hash");
+    }
+
+    /**************************************************************************/
+
+    /** @enum modules
+      *
+      * Defines some fully qualified generators.
+    **/
+    enum modules
+    {
+        THREEFISH,                               // Threefish-256 (64-bit)
+        PCG32,                                   // PCG32 XSH-RR (64-bit)
+        PHILOX,                                  // Philox-4x32-7 (32-bit)
+        HASH,                                    // Stateless hash (32-bit)
+
+        COUNT_
+    };
+
+    /** Returns the generator corresponding to an enum value.
+      *
+      * @param generator  Enum value.
+      *
+      * @return The generator program.
+    **/
+    inline cl::Program get(const modules &generator)
+    {
+        switch (generator)
+        {
+               case   THREEFISH: return threefish();
+               case       PCG32: return pcg32();
+               case      PHILOX: return philox();
+               case        HASH: return hash();
+            default            : throw std::logic_error("Unknown generator");
+        }
+    }
+
+    /** Returns a short name for a generator (e.g. for reports).
+      *
+      * @param generator  Enum value.
+      *
+      * @return The generator name.
+    **/
+    inline const char *name(const modules &generator)
+    {
+        switch (generator)
+        {
+               case   THREEFISH: return "threefish";
+               case       PCG32: return "pcg32";
+               case      PHILOX: return "philox";
+               case        HASH: return "hash";
+            default            : throw std::logic_error("Unknown generator");
+        }
+    }
+};
@@ -9,6 +9,8 @@
 
 #include <CL/cl.hpp>
 #include <stdexcept>
+#include <cstddef>
+#include <string>
 
 #include "setup/scheduler.hpp"
 
@@ -35,6 +37,35 @@ namespace integrators
         return scheduler::acquire("modules/integrators/ao");
     }
 
+    /** Ambient occlusion which traces several occlusion rays from each hit and
+      * ignores any occluders beyond some distance, so that occlusion rays may
+      * stop traversing the geometry early (this is much faster in open areas,
+      * where unbounded rays would walk the tree all the way to its boundary).
+      *
+      * @param rays   The number of occlusion rays per sample.
+      * @param range  The maximum occluder distance (in world units, the world
+      *               spanning [-1, 1] along each axis).
+    **/
+    inline cl::Program bounded_ambient_occlusion(std::size_t rays = 4,
+                                                 float range = 0.25f)
+    {
+        if (rays == 0) throw std::logic_error("AO needs at least one ray");
+        if (!(range > 0)) throw std::logic_error("AO range must be positive");
+
+        std::string def = "-D AO_RAYS=" + std::to_string(rays) + " "
+                        + "-D AO_RANGE=" + std::to_string(range) + "f";
+        return scheduler::acquire("modules/integrators/ao_bounded", def);
+    }
+
+    /** A path tracer over diffuse surfaces, lit by a sun and a sky, which uses
+      * next-event estimation towards the sun and Russian roulette to terminate
+      * paths (the lighting is defined in the integrator's source).
+    **/
+    inline cl::Program path_tracer(void)
+    {
+        return scheduler::acquire("modules/integrators/path");
+    }
+
     /**************************************************************************/
 
     /** @enum modules
@@ -46,6 +77,8 @@ namespace integrators
         DEPTH,
         NORMAL,
         AO,
+        AO_BOUNDED,
+        PATH,
 
         COUNT_
     };
@@ -63,6 +96,27 @@ namespace integrators
                case       DEPTH: return depth();
                case      NORMAL: return normal();
                case          AO: return ambient_occlusion();
+               case  AO_BOUNDED: return bounded_ambient_occlusion();
+               case        PATH: return path_tracer();
+            default            : throw std::logic_error("Unknown integrator");
+        }
+    }
+
+    /** Returns a short name for an integrator (e.g. for file names).
+      *
+      * @param integrator  Enum value.
+      *
+      * @return The integrator name.
+    **/
+    inline const char *name(const modules &integrator)
+    {
+        switch (integrator)
+        {
+               case       DEPTH: return "depth";
+               case      NORMAL: return "normal";
+               case          AO: return "ao";
+               case  AO_BOUNDED: return "ao_bounded";
+               case        PATH: return "path";
             default            : throw std::logic_error("Unknown integrator");
         }
     }
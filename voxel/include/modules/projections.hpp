@@ -59,4 +59,20 @@ namespace projections
             default            : throw std::logic_error("Unknown projection");
         }
     }
+
+    /** Returns a short name for a projection (e.g. for file names).
+      *
+      * @param projection  Enum value.
+      *
+      * @return The projection name.
+    **/
+    inline const char *name(const modules &projection)
+    {
+        switch (projection)
+        {
+               case PERSPECTIVE: return "perspective";
+               case     FISHEYE: return "fisheye";
+            default            : throw std::logic_error("Unknown projection");
+        }
+    }
 };
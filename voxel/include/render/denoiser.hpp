@@ -0,0 +1,36 @@
+// manages the denoising filter (see cl/include/core/filter.cl)
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <string>
+#include <map>
+
+class Denoiser
+{
+    public:
+        Denoiser(std::size_t width, std::size_t height);
+
+        void resize(std::size_t width, std::size_t height);
+
+        /** Sets the number of filter passes (zero disables denoising).
+        **/
+        void set_passes(std::size_t passes);
+
+        /** Filters a frame buffer through all passes.
+          *
+          * @param kernels  The kernels (containing the \c denoise kernel).
+          * @param input    The frame buffer to filter.
+          *
+          * @return The filtered frame buffer, which is \c input itself if the
+          *         denoiser is disabled, and one of the denoiser's buffers
+          *         otherwise (valid until the next call).
+        **/
+        const cl::Buffer &run(std::map<std::string, cl::Kernel> &kernels,
+                              const cl::Buffer &input);
+
+    private:
+        std::size_t count, passes;
+        cl::Buffer buffers[2]; // ping-pong
+};
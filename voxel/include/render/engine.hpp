@@ -8,35 +8,57 @@
 #include <vector>
 #include <map>
 
+#include "render/denoiser.hpp"
+#include "render/samples.hpp"
 #include "render/frame.hpp"
+#include "render/post.hpp"
 
 class Engine
 {
     public:
         enum Module
         {
-            SUBSAMPLER,
             PROJECTION,
             INTEGRATOR,
+            GENERATOR,
         };
 
         /** Creates a new Engine with an initial set of parameters.
           *
-          * @param subsampler  Initial subsampler module.
           * @param projection  Initial projection module.
           * @param integrator  Initial integrator module.
-          * @param image       OpenGL/OpenCL image to draw into.
+          * @param generator   Initial PRNG generator module.
+          * @param image       OpenCL (or OpenGL/OpenCL) image to draw into.
         **/
-        Engine(const cl::Program &subsampler,
-               const cl::Program &projection,
+        Engine(const cl::Program &projection,
                const cl::Program &integrator,
-               const cl::ImageGL &image);
+               const cl::Program &generator,
+               const cl::Image &image);
 
         /** Resizes the frame to new dimensions.
           *
           * @param image   New image.
         **/
-        void resize_frame(const cl::ImageGL &image);
+        void resize_frame(const cl::Image &image);
+
+        /** Renders a tile of a larger image into the frame from now on (see
+          * \c Frame::set_tile()), which also clears the frame.
+        **/
+        void set_tile(size_t x, size_t y, size_t width, size_t height,
+                      size_t image_width, size_t image_height);
+
+        /** Renders at a fraction of the full resolution from now on (see \c
+          * Frame::set_scale()), which also clears the frame.
+        **/
+        void set_scale(float scale);
+
+        /** Sets up a new subsampler pattern (subsamplers are not modules, so
+          * this does not cause the kernels to be rebuilt).
+          *
+          * @param pattern  The sample point pattern.
+          * @param count    The number of sample points.
+        **/
+        void set_subsampler(SampleTable::Pattern pattern, size_t count);
 
         /** Sets up a new module for rendering, replacing the previous one.
           *
@@ -49,11 +71,34 @@ class Engine
         **/
         void clear_frame(void);
 
+        /** Clears the frame and restarts its frame counter (see \c Frame).
+        **/
+        void reset_frame(void);
+
         /** Adds another sample to the frame.
         **/
         void sample(void);
 
-        void draw(void); // this is where the post-processing goes
+        /** Denoises and post-processes the frame into the image.
+        **/
+        void draw(void);
+
+        /** Returns the post-processing settings applied by \c draw().
+        **/
+        PostProcess &post_process(void);
+
+        /** Enables or disables the arbitrary output variables (depth, normal
+          * and material of the primary hit), written alongside each sample.
+        **/
+        void set_aovs(bool enabled);
+
+        /** Reads back the AOV's of the last sample (they must be enabled).
+        **/
+        AOVs read_aovs(void);
+
+        /** Returns the denoiser applied by \c draw() (disabled by default).
+        **/
+        Denoiser &denoiser(void);
 
         /** Convenience function which attaches an arbitrary object, as long as
           * it has an accessible \c notify_cb callback member function with the
@@ -96,5 +141,8 @@ class Engine
         std::map<Module, cl::Program> modules;
         std::vector<cl::Program> core;
         cl::Program program;
+        PostProcess post;
         Frame frame;
+        Denoiser filter;
+        SampleTable samples;
 };
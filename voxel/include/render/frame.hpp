@@ -3,7 +3,9 @@
 #pragma once
 
 #include <CL/cl.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <map>
 
 #include "setup/scheduler.hpp"
@@ -11,28 +13,92 @@
 struct FrameInfo
 {
     cl_uint width, height;
+    cl_uint offset_x, offset_y;
+    cl_uint image_width, image_height;
+    cl_uint output_width, output_height;
     cl_ulong counter;
+    cl_uint aovs;
+    cl_uint sample; // index of the sample since the frame was cleared
 } __attribute__((packed));
 
+/** @struct AOVs
+  *
+  * The arbitrary output variables of the primary hits of the last sample, for
+  * each pixel, stored top-down row by row.
+**/
+struct AOVs
+{
+    std::size_t width, height;
+    std::vector<float> depth;       // distance, or -1 if no hit
+    std::vector<float> normal;      // face normal (xyz), or zero if no hit
+    std::vector<uint16_t> material; // material ID, or 0xFFFF if no hit
+};
+
 class Frame
 {
     public:
-        Frame(const cl::ImageGL &image);
+        Frame(const cl::Image &image);
 
         void next();
 
+        /** Renders the frame at a fraction of the image resolution (which is
+          * upscaled when drawn), which also clears the frame.
+          *
+          * @param scale  The scale factor, in (0, 1] (one is full resolution).
+        **/
+        void set_scale(float scale);
+
         void notify_cb(std::map<std::string, cl::Kernel> &kernels);
 
-        void resize(const cl::ImageGL &image);
+        void resize(const cl::Image &image);
+
+        /** Makes the frame render a tile of a larger image, so that very large
+          * images can be rendered tile by tile (the tile must fit the frame).
+          *
+          * @param x       The horizontal offset of the tile in the image.
+          * @param y       The vertical offset of the tile (from the top).
+          * @param width   The width of the tile.
+          * @param height  The height of the tile.
+          * @param image_width   The width of the entire image.
+          * @param image_height  The height of the entire image.
+        **/
+        void set_tile(size_t x, size_t y, size_t width, size_t height,
+                      size_t image_width, size_t image_height);
 
         void clear(void);
 
+        /** Clears the frame and restarts its frame counter, so that the samples
+          * rendered afterwards do not depend on how many came before.
+        **/
+        void reset(void);
+
         size_t width();
         size_t height();
 
+        /** Returns the number of pixels being rendered, which is less than \c
+          * width() * \c height() when rendering a tile or at a lower scale.
+        **/
+        size_t pixels();
+
+        /** Returns the frame buffer (in RGBn format).
+        **/
+        const cl::Buffer &buffer();
+
+        /** Enables or disables the AOV buffers (the material buffer is only
+          * allocated while they are enabled).
+        **/
+        void set_aovs(bool enabled);
+
+        /** Reads back the AOV buffers (which must be enabled).
+        **/
+        AOVs read_aovs();
+
     private:
-        cl::ImageGL image;
+        cl::Image image;
         cl::Buffer frame_buffer;
+        cl::Buffer feature_buffer;
+        cl::Buffer material_buffer;
         cl::Buffer frame_info;
         FrameInfo info;
+        cl_uint samples; // since the frame was cleared
 };
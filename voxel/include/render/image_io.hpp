@@ -0,0 +1,121 @@
+/** @file image_io.hpp
+  *
+  * @brief Image File Input/Output
+  *
+  * Minimal readers and writers for the binary Netpbm formats, which are enough
+  * to save renders and load reference images without any external libraries,
+  * along with writers for 16-bit PGM and floating-point PFM images (for AOV's).
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** @namespace image_io
+  *
+  * @brief Namespace for image file I/O
+  *
+  * Pixels are stored top-down, row by row, with 8-bit RGB channels.
+**/
+namespace image_io
+{
+    /** Writes an image to a binary PPM file.
+      *
+      * @param path    The file path.
+      * @param width   The image width, in pixels.
+      * @param height  The image height, in pixels.
+      * @param rgb     The image pixels (\c width * \c height * 3 bytes).
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool write_ppm(const std::string &path, std::size_t width,
+                   std::size_t height, const std::vector<uint8_t> &rgb);
+
+    /** @class PPMStream
+      *
+      * Writes a binary PPM file a few rows at a time, so that the entire image
+      * never needs to be held in memory (e.g. for very large tiled renders).
+    **/
+    class PPMStream
+    {
+        public:
+            /** Creates the file and writes the header.
+              *
+              * @param path    The file path.
+              * @param width   The image width, in pixels.
+              * @param height  The image height, in pixels.
+            **/
+            PPMStream(const std::string &path, std::size_t width,
+                      std::size_t height);
+
+            /** Appends rows of pixels below those already written.
+              *
+              * @param rgb  The pixels of one or more entire rows.
+              *
+              * @return \c true on success, \c false otherwise.
+            **/
+            bool write_rows(const std::vector<uint8_t> &rgb);
+
+            /** Returns whether all rows were successfully written.
+            **/
+            bool complete(void) const;
+
+        private:
+            std::ofstream file;
+            std::size_t width, height, rows;
+    };
+
+    /** Reads an image from a binary PPM file (with a maximum value of 255).
+      *
+      * @param path    The file path.
+      * @param width   The image width, in pixels.
+      * @param height  The image height, in pixels.
+      * @param rgb     The image pixels.
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool read_ppm(const std::string &path, std::size_t &width,
+                  std::size_t &height, std::vector<uint8_t> &rgb);
+
+    /** Writes a 16-bit grayscale image to a binary PGM file.
+      *
+      * @param path    The file path.
+      * @param width   The image width, in pixels.
+      * @param height  The image height, in pixels.
+      * @param gray    The image pixels (\c width * \c height values).
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool write_pgm(const std::string &path, std::size_t width,
+                   std::size_t height, const std::vector<uint16_t> &gray);
+
+    /** Writes a floating-point image to a PFM file.
+      *
+      * @param path      The file path.
+      * @param width     The image width, in pixels.
+      * @param height    The image height, in pixels.
+      * @param channels  The number of channels (1 or 3).
+      * @param data      The image pixels (\c width * \c height * \c channels
+      *                  values).
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool write_pfm(const std::string &path, std::size_t width,
+                   std::size_t height, std::size_t channels,
+                   const std::vector<float> &data);
+
+    /** Converts an RGBA image read back from the device into top-down RGB.
+      *
+      * @param width   The image width, in pixels.
+      * @param height  The image height, in pixels.
+      * @param rgba    The image pixels, bottom-up (as OpenGL textures are).
+      *
+      * @return The image pixels in the format used by this unit.
+    **/
+    std::vector<uint8_t> from_texture(std::size_t width, std::size_t height,
+                                      const std::vector<uint8_t> &rgba);
+};
@@ -0,0 +1,50 @@
+// manages the post-processing settings (see cl/include/core/post_proc.cl)
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <string>
+#include <map>
+
+class PostProcess
+{
+    public:
+        /** @enum Operator
+          *
+          * The available tonemapping operators.
+        **/
+        enum Operator
+        {
+            LINEAR,                              // Clip only (no tonemapping)
+            REINHARD,                            // Reinhard, c / (1 + c)
+            FILMIC,                              // Hable's filmic curve
+
+            COUNT_
+        };
+
+        PostProcess();
+
+        /** Sets the exposure, in stops (zero leaves intensities unchanged).
+        **/
+        void set_exposure(float stops);
+
+        void set_operator(Operator op);
+        void set_srgb(bool enabled);
+        void set_dither(bool enabled);
+
+        void notify_cb(std::map<std::string, cl::Kernel> &kernels);
+
+    private:
+        struct Buffer
+        {
+            cl_float exposure;
+            cl_uint op;
+            cl_uint srgb;
+            cl_uint dither;
+        } __attribute__((packed));
+
+        Buffer buffer;
+        cl::Buffer mem;
+
+        void update(void);
+};
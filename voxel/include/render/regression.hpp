@@ -0,0 +1,41 @@
+/** @file regression.hpp
+  *
+  * @brief Golden-Image Regression Suite
+  *
+  * Renders a fixed scene headlessly (without any OpenGL interop) through each
+  * integrator and projection, and compares the results against stored golden
+  * images, within a small tolerance. The render kernel time of each case gets
+  * recorded as well, so that optimizations can be checked not to change the
+  * image while their effect on throughput is measured.
+  *
+  * The PRNG is seeded from the pixel, frame counter and frame dimensions only,
+  * and the frame counter is restarted for each case, so that each case is
+  * deterministic given a device and fixed sample count (whatever the order the
+  * cases are run in).
+**/
+
+#pragma once
+
+#include <string>
+
+#include "world/world.hpp"
+
+/** @namespace regression
+  *
+  * @brief Namespace for the regression suite
+**/
+namespace regression
+{
+    /** Runs every test case.
+      *
+      * @param world  The world to render (using its initial observer).
+      * @param dir    The directory holding the reference images, into which
+      *               the timings and any mismatching renders are written.
+      * @param bless  Whether to save the render of cases without a reference
+      *               image as their new reference (which should then be checked
+      *               by hand), rather than failing them.
+      *
+      * @return \c true if all cases match their reference, \c false otherwise.
+    **/
+    bool run(World &world, const std::string &dir, bool bless);
+};
@@ -0,0 +1,47 @@
+// manages the subsampler's table of sample points (see core/subsampler.cl)
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <string>
+#include <map>
+
+class SampleTable
+{
+    public:
+        /** @enum Pattern
+          *
+          * The available sample point patterns, all of which are progressive
+          * (any prefix of the table is itself well distributed).
+        **/
+        enum Pattern
+        {
+            NONE,                                // Pixel centers only
+            HALTON,                              // Halton sequence (2, 3)
+            SOBOL,                               // Sobol (0,2)-sequence
+            PMJ,                                 // Progressive multi-jittered
+
+            COUNT_
+        };
+
+        SampleTable(Pattern pattern, std::size_t count);
+
+        /** Generates a new table and uploads it (this does not require the
+          * kernels to be rebuilt, only to be rebound).
+          *
+          * @param pattern  The sample point pattern.
+          * @param count    The number of sample points (ignored for \c NONE).
+        **/
+        void set(Pattern pattern, std::size_t count);
+
+        void notify_cb(std::map<std::string, cl::Kernel> &kernels);
+
+        /** Returns a short name for a pattern (e.g. for file names).
+        **/
+        static const char *name(Pattern pattern);
+
+    private:
+        cl::Buffer mem;
+        cl_uint count;
+};
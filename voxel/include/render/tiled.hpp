@@ -0,0 +1,39 @@
+/** @file tiled.hpp
+  *
+  * @brief Tiled Still Rendering
+  *
+  * Renders a still image headlessly (without any OpenGL interop) one tile at a
+  * time, each tile being accumulated, post-processed and read back before the
+  * next one is started. Finished rows of tiles are streamed to the output file
+  * so that neither device nor host memory usage depends on the image height,
+  * and device memory usage does not depend on the image width either.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "world/world.hpp"
+
+/** @namespace tiled
+  *
+  * @brief Namespace for tiled still rendering
+**/
+namespace tiled
+{
+    /** Renders a still image to a file.
+      *
+      * @param world    The world to render (using its current observer).
+      * @param width    The image width, in pixels.
+      * @param height   The image height, in pixels.
+      * @param samples  The number of samples per pixel.
+      * @param path     The output file path (a binary PPM image).
+      * @param tile     The tile size, in pixels.
+      *
+      * @return \c true on success, \c false otherwise.
+    **/
+    bool render(World &world, std::size_t width, std::size_t height,
+                std::size_t samples, const std::string &path,
+                std::size_t tile = 512);
+};
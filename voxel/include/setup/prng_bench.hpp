@@ -0,0 +1,29 @@
+/** @file prng_bench.hpp
+  *
+  * @brief PRNG Generator Benchmark
+  *
+  * Runs each PRNG generator module on the device, to measure its throughput
+  * and some basic statistics about its output, so that the fastest generator
+  * of acceptable quality can be picked for a given device.
+  *
+  * The statistics only catch gross defects (bias, correlation between values
+  * consecutively generated, unbalanced bits, uneven distribution) and are no
+  * substitute for a proper test suite.
+**/
+
+#pragma once
+
+/** @namespace prng_bench
+  *
+  * @brief Namespace for the PRNG benchmark
+**/
+namespace prng_bench
+{
+    /** Benchmarks every generator and logs the results (the scheduler must
+      * have been set up beforehand).
+      *
+      * @return \c true if all generators passed the statistical checks, and
+      *         \c false otherwise.
+    **/
+    bool run(void);
+};
@@ -0,0 +1,67 @@
+/** @file profiler.hpp
+  *
+  * @brief Device Profiling
+  *
+  * This unit collects the device-side start and end times of commands enqueued
+  * by the scheduler (kernels, uploads, interop acquire/release, ...) in a ring
+  * buffer, and provides rolling averages and a summary of them.
+  *
+  * Profiling is optional, as it requires the command queue to be created with
+  * \c CL_QUEUE_PROFILING_ENABLE, which may have some small runtime overhead.
+**/
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <string>
+
+/** @namespace profiler
+  *
+  * @brief Namespace for the profiler
+  *
+  * Contains functions to record and query command timings.
+**/
+namespace profiler
+{
+    /** Enables profiling (this must be done before the scheduler is set up).
+    **/
+    void enable(void);
+
+    /** Returns whether profiling has been enabled.
+    **/
+    bool enabled(void);
+
+    /** Returns an event to pass to an enqueue call, such that the command gets
+      * profiled under the given name.
+      *
+      * @param name  The name of the command (e.g. the kernel name).
+      *
+      * @return A pointer to an event, or \c nullptr if profiling is disabled.
+      *
+      * @remarks The pointer is only valid until the next call to this function.
+    **/
+    cl::Event *track(const std::string &name);
+
+    /** Moves all completed commands into the ring buffer of timings.
+      *
+      * @param wait  Whether to wait for pending commands to complete.
+    **/
+    void collect(bool wait = false);
+
+    /** Returns the rolling average duration of a named command.
+      *
+      * @param name  The name of the command.
+      *
+      * @return The average duration in milliseconds, or zero if unknown.
+    **/
+    double average(const std::string &name);
+
+    /** Waits for all pending commands and then forgets all timings.
+    **/
+    void reset(void);
+
+    /** Logs a summary of all timings since profiling was enabled.
+    **/
+    void summary(void);
+};
@@ -55,6 +55,11 @@ namespace scheduler
 
     cl::ImageGL alloc_gl_image(cl_mem_flags flags, GLuint texture);
 
+    cl::Image2D alloc_image(std::size_t width, std::size_t height);
+
+    void read_image(const cl::Image &image, std::size_t width,
+                    std::size_t height, void *ptr);
+
     void clear_gl_image(cl::Image &image, std::size_t width, std::size_t height);
 
     void clear_buffer(cl::Buffer &buffer, std::size_t size);
@@ -67,4 +72,9 @@ namespace scheduler
 
     void read(const cl::Buffer &buffer, std::size_t offset, std::size_t size,
               void *ptr, bool blocking = false);
+
+    // maps a buffer allocated with CL_MEM_ALLOC_HOST_PTR to get pinned memory
+    void *map(const cl::Buffer &buffer, std::size_t size, cl_map_flags flags);
+
+    void unmap(const cl::Buffer &buffer, void *ptr);
 };
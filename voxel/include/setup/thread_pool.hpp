@@ -0,0 +1,67 @@
+/** @file thread_pool.hpp
+  *
+  * @brief Host Thread Pool
+  *
+  * A fixed set of worker threads which run the iterations of a loop in parallel
+  * (e.g. to decompress geometry pages while streaming), so that threads do not
+  * need to be started for every batch of work.
+**/
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+/** @class ThreadPool
+  *
+  * Runs one parallel loop at a time, the calling thread taking part as well.
+**/
+class ThreadPool
+{
+    public:
+        /** Starts the worker threads.
+          *
+          * @param threads  The number of threads to run loops on (including
+          *                 the calling thread), or zero for one per core.
+        **/
+        explicit ThreadPool(std::size_t threads = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        std::size_t size(void) const;
+
+        /** Runs a task for each index from zero to \c count (exclusive), in no
+          * particular order, and waits for all of them to complete.
+          *
+          * @param count  The number of iterations.
+          * @param task   The task, which is passed the index of the iteration.
+          *
+          * @remarks If any iteration throws, the first exception is rethrown
+          *          here (once all iterations have completed).
+        **/
+        void run(std::size_t count,
+                 const std::function<void(std::size_t)> &task);
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake, done;
+
+        /* The loop being run, all of which is guarded by the mutex. */
+        const std::function<void(std::size_t)> *task;
+        std::size_t count, next, pending;
+        std::size_t generation;
+        std::exception_ptr error;
+        bool stopping;
+
+        void work(void);
+        void drain(std::unique_lock<std::mutex> &lock);
+};
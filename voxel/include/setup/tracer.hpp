@@ -0,0 +1,77 @@
+/** @file tracer.hpp
+  *
+  * @brief Timeline Tracing
+  *
+  * This unit records a timeline of host activity (as scoped zones) and device
+  * activity (as profiled commands, see \c profiler.hpp) on a common clock, and
+  * writes it out in the Chrome trace event format, which can be viewed with a
+  * trace viewer such as \c chrome://tracing for a chosen number of frames.
+**/
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <string>
+
+/** @namespace tracer
+  *
+  * @brief Namespace for the tracer
+  *
+  * Contains functions to record host zones and device commands.
+**/
+namespace tracer
+{
+    /** Enables tracing (this must be done before the scheduler is set up, and
+      * also requires the profiler to be enabled for device commands).
+      *
+      * @param path    The path of the trace file to write.
+      * @param frames  The number of frames to trace.
+    **/
+    void enable(const std::string &path, std::size_t frames);
+
+    /** Returns whether tracing is (still) enabled.
+    **/
+    bool enabled(void);
+
+    /** Maps the device clock onto the host clock used for zones.
+      *
+      * @param device_ns  A device timestamp which has just been reached.
+    **/
+    void calibrate(cl_ulong device_ns);
+
+    /** Records a device command.
+      *
+      * @param name   The name of the command.
+      * @param start  The device timestamp at which the command started.
+      * @param end    The device timestamp at which the command ended.
+    **/
+    void device(const std::string &name, cl_ulong start, cl_ulong end);
+
+    /** Marks the start of a frame (and the end of the previous one), writing
+      * out the trace once the requested number of frames has been completed,
+      * after which tracing is disabled.
+      *
+      * @remarks Everything before the first frame is traced too (as startup).
+    **/
+    void frame(void);
+
+    /** Writes out the trace immediately if it is still enabled.
+    **/
+    void finish(void);
+
+    /** @class Zone
+      *
+      * A scoped host zone, which spans the lifetime of the object.
+    **/
+    class Zone
+    {
+        public:
+            Zone(const std::string &name);
+            ~Zone();
+
+        private:
+            std::string name;
+            double start;
+    };
+};
@@ -0,0 +1,133 @@
+// manages the paged geometry on the device (see cl/include/core/geometry.cl)
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "geometry/pages.hpp"
+#include "math/vector3.hpp"
+#include "setup/thread_pool.hpp"
+#include "world/grid.hpp"
+
+class PagedGeometry
+{
+    public:
+        /** The number of nodes per page, and the number of entries in the page
+          * request table (both of these are also defined in the kernels).
+        **/
+        static const std::size_t PAGE_NODES = 1024;
+        static const std::size_t REQUEST_SLOTS = 1024;
+
+        /** @struct Stats
+          *
+          * Cumulative streaming statistics, since the geometry was opened.
+        **/
+        struct Stats
+        {
+            std::size_t hits;     // resident pages used, summed over frames
+            std::size_t misses;   // requests for pages not resident
+            std::size_t uploaded; // bytes written to the device
+            std::size_t evicted;  // pages evicted
+            std::size_t prefetched; // pages loaded ahead of any request
+            std::size_t read;     // bytes read from the page file
+        };
+
+        /** Returns the size of a page on the device, in bytes.
+        **/
+        static std::size_t page_size(void);
+
+        /** Opens a page file, along with its chunk grid (no chunks being
+          * resident until they are first shown, see update()).
+          *
+          * @param path   The path of the page file.
+          * @param slots  The number of pages the device can hold.
+        **/
+        PagedGeometry(const std::string &path, std::size_t slots);
+
+        ~PagedGeometry();
+
+        /** Makes the root pages of the given chunks resident (as far as the
+          * budget allows, in order), then loads the pages requested by the
+          * kernels since the last call, linking them into their tree (this
+          * is to be done between frames). If there are no free slots, the
+          * least recently used pages (and any of their descendants) are
+          * evicted, except those used since the last call, so the trees may
+          * not be complete within a small budget. Chunks not resident are
+          * skipped by the kernels as if they were empty.
+          *
+          * Pages are read from the file in turn, but decompressed on all cores
+          * (into pinned memory, from which they are uploaded).
+          *
+          * @param chunks  The chunks in view (see ChunkGrid::visible()).
+          *
+          * @return The number of pages loaded.
+        **/
+        std::size_t update(const std::vector<uint32_t> &chunks);
+
+        /** Loads a few pages which are not yet resident, but which lie within
+          * a view cone and are reachable from the resident pages, nearest to
+          * the apex first (this is to be done after update()). Only pages not
+          * used for a while are evicted to make room for them, so this never
+          * takes the place of pages that are actually in view.
+          *
+          * @param pos     The apex of the cone (a predicted observer position).
+          * @param dir     The axis of the cone (a predicted view direction).
+          * @param fov     The vertical field of view, in radians.
+          * @param aspect  The aspect ratio of the frame (width / height).
+          *
+          * @return The number of pages loaded.
+        **/
+        std::size_t prefetch(const math::float3 &pos, const math::float3 &dir,
+                             float fov, float aspect);
+
+        const ChunkGrid &chunks(void) const;
+
+        std::size_t resident(void) const;
+        const Stats &stats(void) const;
+
+        void notify_cb(std::map<std::string, cl::Kernel> &kernels);
+
+    private:
+        static const uint32_t NO_SLOT = 0xFFFFFFFF;
+
+        struct Placement
+        {
+            uint32_t page, slot;
+        };
+
+        struct Header
+        {
+            cl_uint frame, slots, grid[3], padding[3];
+            cl_uint request[REQUEST_SLOTS];
+        };
+
+        PageFile file;
+        ChunkGrid grid;
+        std::vector<uint32_t> cell_of;               // per chunk
+        std::vector<std::vector<uint32_t>> children; // per page
+        std::vector<uint32_t> slot_of;               // per page
+        std::vector<uint32_t> page_in;               // per slot
+        std::vector<cl_uint> stamps;                 // per slot
+        std::vector<uint32_t> free_slots;
+        std::vector<Placement> pending;              // not yet uploaded
+        std::vector<std::vector<uint8_t>> compressed;
+        ThreadPool workers;
+        Header header;
+        Stats counters;
+        cl::Buffer mem, staging;
+        Node *staged;                                // mapped staging buffer
+
+        std::size_t cell_offset(uint32_t cell) const;
+        uint32_t node_pointer(uint32_t slot, uint32_t node) const;
+        std::size_t node_offset(uint32_t slot, uint32_t node) const;
+        void link(uint32_t page_id, uint32_t slot);
+        void place(uint32_t page_id);
+        void flush(void);
+        void evict(uint32_t page_id);
+        bool reclaim(cl_uint age);
+};
@@ -0,0 +1,66 @@
+// the uniform grid of chunks the world is divided into (see geometry.cl)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/vector3.hpp"
+#include "geometry/aabb.hpp"
+
+class Observer;
+
+class ChunkGrid
+{
+    public:
+        /** The edge length of a chunk in world units (also defined in the
+          * kernels), the grid being centered on the origin. Each chunk has its
+          * own octree, spanning the chunk as the [-1, 1] cube would.
+        **/
+        static const float CHUNK_SIZE;
+
+        static const uint32_t NO_CHUNK = 0xFFFFFFFF;
+
+        /** Creates a grid of empty cells.
+          *
+          * @param width   The number of cells along the x-axis.
+          * @param height  The number of cells along the y-axis.
+          * @param depth   The number of cells along the z-axis.
+        **/
+        ChunkGrid(uint32_t width, uint32_t height, uint32_t depth);
+
+        uint32_t width(void) const;
+        uint32_t height(void) const;
+        uint32_t depth(void) const;
+
+        /** Returns the number of cells, which are indexed with x varying the
+          * fastest and z the slowest.
+        **/
+        std::size_t cells(void) const;
+
+        uint32_t cell(uint32_t x, uint32_t y, uint32_t z) const;
+        aabb bounds(uint32_t cell) const;
+
+        /** Sets the chunk in a cell (the chunk being a tree in a page file, so
+          * this is the ID of its root page), or \c NO_CHUNK if it is empty.
+        **/
+        void set_chunk(uint32_t cell, uint32_t chunk);
+        uint32_t chunk(uint32_t cell) const;
+
+        /** Returns the chunks which may be visible to an observer, that is,
+          * those intersecting the view frustum, and those adjacent to (or
+          * containing) the observer, as secondary rays often reach them.
+          *
+          * @param observer  The observer.
+          * @param aspect    The aspect ratio of the frame (width / height).
+          *
+          * @return The chunks, ordered by their distance to the observer.
+        **/
+        std::vector<uint32_t> visible(const Observer &observer,
+                                      float aspect) const;
+
+    private:
+        uint32_t size[3];
+        std::vector<uint32_t> chunks; // per cell
+};
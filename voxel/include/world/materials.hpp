@@ -0,0 +1,53 @@
+// manages the material database (see cl/include/core/material.cl)
+
+#pragma once
+
+#include <CL/cl.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "math/vector3.hpp"
+
+class MaterialDB
+{
+    public:
+        /** The maximum number of materials, such that the packed table fits in
+          * constant memory (along with the other constant kernel arguments).
+        **/
+        static const std::size_t MAX_MATERIALS = 4096;
+
+        /** Creates a database containing only the default material (with ID
+          * zero), used by all leaves whose material ID is not in the table.
+        **/
+        MaterialDB();
+
+        /** Sets a material, growing the table if needed (any materials added
+          * in between being copies of the default material).
+          *
+          * @param id        The material ID (below \c MAX_MATERIALS).
+          * @param albedo    The diffuse albedo (clamped to [0, 1]).
+          * @param emission  The emitted radiance (clamped to [0, 65408]).
+          *
+          * @remarks The table is only sent to the device by \c upload().
+        **/
+        void set(uint16_t id, const math::float3 &albedo,
+                 const math::float3 &emission = math::float3(0, 0, 0));
+
+        std::size_t size(void) const;
+
+        void upload(void);
+
+        void notify_cb(std::map<std::string, cl::Kernel> &kernels);
+
+    private:
+        struct Header
+        {
+            cl_uint count, padding;
+        } __attribute__((packed));
+
+        std::vector<cl_uint2> table;
+        cl::Buffer mem;
+};
@@ -8,6 +8,7 @@
 #include "math/vector3.hpp"
 #include "math/matrix3x3.hpp"
 #include "math/common.hpp"
+#include "geometry/aabb.hpp"
 
 class Observer
 {
@@ -24,6 +25,18 @@ class Observer
 
         void set_fov(float fov);
 
+        const math::float3 &position(void) const;
+        const math::float3 &direction(void) const;
+        float fov(void) const; // in radians
+
+        /** Returns whether a box may be in view, i.e. whether it is not wholly
+          * outside the perspective view frustum (this is conservative).
+          *
+          * @param box     The box.
+          * @param aspect  The aspect ratio of the frame (width / height).
+        **/
+        bool in_view(const aabb &box, float aspect) const;
+
         void notify_cb(std::map<std::string, cl::Kernel> &kernels);
 
     private:
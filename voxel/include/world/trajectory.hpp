@@ -0,0 +1,32 @@
+// extrapolates the observer's recent motion (e.g. to prefetch geometry)
+
+#pragma once
+
+#include "math/vector3.hpp"
+
+class Trajectory
+{
+    public:
+        Trajectory();
+
+        /** Records the observer's position and view direction for a frame.
+        **/
+        void record(const math::float3 &pos, const math::float3 &dir);
+
+        /** Returns whether the observer has been moving or turning recently.
+        **/
+        bool moving(void) const;
+
+        /** Predicts the observer's position some number of frames ahead.
+        **/
+        math::float3 position(float frames) const;
+
+        /** Predicts the observer's view direction some number of frames ahead.
+        **/
+        math::float3 direction(float frames) const;
+
+    private:
+        math::float3 pos, dir;
+        math::float3 velocity, turn; // per frame, smoothed
+        bool recorded;
+};
@@ -1,29 +1,69 @@
-// this will contain the world later on (e.g. the voxel disk/memory streaming
-// code, the geometry buffer, the observer, the material database, etc....)
+// this contains the world (the streamed geometry, the observer, the material
+// database, etc...)
 
 #pragma once
 
 #include <CL/cl.hpp>
+#include <functional>
+#include <cstddef>
 #include <string>
 #include <map>
 
-#include "geometry/voxel_test.hpp"
+#include "world/geometry.hpp"
 #include "world/observer.hpp"
+#include "world/materials.hpp"
+#include "world/trajectory.hpp"
 
 class World
 {
     public:
-        World();
+        /** The default device memory budget for geometry pages, in bytes.
+        **/
+        static const std::size_t DEFAULT_PAGE_BUDGET = 32 << 20;
+
+        /** Opens a world.
+          *
+          * @param path         The path of the world's page file, or empty
+          *                     for the procedural test world.
+          * @param page_budget  The device memory budget for geometry pages.
+        **/
+        explicit World(const std::string &path = "",
+                       std::size_t page_budget = DEFAULT_PAGE_BUDGET);
 
         void notify_cb(std::map<std::string, cl::Kernel> &kernels);
 
+        /** Streams in the chunks in view and the geometry requested while
+          * rendering the last frame, then prefetches geometry along the
+          * observer's predicted path (the frame then needs to be cleared if
+          * this returns \c true).
+          *
+          * @param aspect  The aspect ratio of the frame (width / height).
+        **/
+        bool update(float aspect);
+
+        /** Renders frames, updating after each, until all of the geometry in
+          * view is resident (which may take a few frames, as pages are only
+          * requested once their parent is resident).
+          *
+          * @param aspect  The aspect ratio of the frame (width / height).
+          * @param render  Renders a frame.
+          *
+          * @return \c false if the geometry did not settle within a bounded
+          *         number of frames (e.g. if the page budget cannot hold the
+          *         geometry in view), \c true otherwise.
+        **/
+        bool settle(float aspect, const std::function<void(void)> &render);
+
+        const PagedGeometry &pages(void) const;
+
         void turn_h(const float amount);
         void turn_v(const float amount);
         void forward(const float amount);
 
     private:
 
-        VoxelTest geometry_o;
-        cl::Buffer geometry;
+        PagedGeometry geometry;
         Observer observer;
+        MaterialDB materials;
+        Trajectory trajectory;
 };
@@ -0,0 +1,330 @@
+#include "geometry/builder.hpp"
+
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+
+/* Interleaves the bits of a voxel's coordinates within its chunk, the x bit *
+ * being the highest of each triple (as in the octant order of geometry.cl). */
+static uint64_t morton(uint32_t x, uint32_t y, uint32_t z, uint32_t levels)
+{
+    uint64_t code = 0;
+
+    for (uint32_t b = levels; b-- > 0; )
+        code = (code << 3) | (((x >> b) & 1) << 2)
+                           | (((y >> b) & 1) << 1)
+                           | (((z >> b) & 1) << 0);
+
+    return code;
+}
+
+/* Stands in for hidden voxels until their node is complete (as it has bits *
+ * set which encode_leaf() never sets, it is never a valid leaf).           */
+static const uint32_t HIDDEN_LEAF = LEAF_FLAG | 1;
+
+/* Builds an octree bottom-up from leaves added in Morton order, holding the *
+ * node being filled at each level. Nodes are emitted as soon as they are    *
+ * complete, and those whose children are all the same leaf are merged into *
+ * that leaf (except for the root, which is always the first node). Hidden   *
+ * children match any leaf, and are otherwise left empty.                    */
+class TreeBuilder
+{
+    public:
+        explicit TreeBuilder(uint32_t levels)
+            : levels(levels), open(levels, false), prefix(levels),
+              filling(levels), nodes(1)
+        {
+
+        }
+
+        void add(uint64_t code, uint32_t leaf)
+        {
+            put(levels - 1, code >> 3, code & 7, leaf);
+        }
+
+        const std::vector<Node> &finish(void)
+        {
+            for (uint32_t level = levels; level-- > 0; )
+                if (open[level]) close(level);
+
+            /* The chunk may turn out empty if all of its voxels are hidden. */
+            const uint32_t *root = nodes[0].child;
+            if (std::all_of(root, root + 8, [](uint32_t c) { return !c; }))
+                nodes.clear();
+
+            return nodes;
+        }
+
+    private:
+        uint32_t levels;
+        std::vector<bool> open;        // per level
+        std::vector<uint64_t> prefix;  // per level
+        std::vector<Node> filling;     // per level
+        std::vector<Node> nodes;
+
+        void put(uint32_t level, uint64_t node, uint32_t slot, uint32_t ptr)
+        {
+            if (open[level] && (prefix[level] != node)) close(level);
+
+            if (!open[level])
+            {
+                open[level] = true;
+                prefix[level] = node;
+                filling[level] = Node{{0}};
+            }
+
+            filling[level].child[slot] = ptr;
+        }
+
+        void close(uint32_t level)
+        {
+            Node node = filling[level];
+            open[level] = false;
+
+            /* Hidden children take on the leaf their siblings merge into. */
+            uint32_t ptr = HIDDEN_LEAF;
+            bool uniform = true;
+
+            for (uint32_t child : node.child)
+                if (child != HIDDEN_LEAF)
+                {
+                    uniform = uniform && (child & LEAF_FLAG)
+                           && ((ptr == HIDDEN_LEAF) || (child == ptr));
+                    ptr = child;
+                }
+
+            if ((level > 0) && uniform)
+            {
+                put(level - 1, prefix[level] >> 3, prefix[level] & 7, ptr);
+                return;
+            }
+
+            /* Otherwise, they are left empty as that needs no more nodes. */
+            for (uint32_t &child : node.child)
+                if (child == HIDDEN_LEAF) child = 0;
+
+            if (level == 0)
+            {
+                nodes[0] = node;
+                return;
+            }
+
+            ptr = (uint32_t)nodes.size();
+            nodes.push_back(node);
+
+            put(level - 1, prefix[level] >> 3, prefix[level] & 7, ptr);
+        }
+};
+
+SVOBuilder::SVOBuilder(uint32_t width, uint32_t height, uint32_t depth,
+                       uint32_t levels, const std::string &scratch,
+                       std::size_t memory)
+    : size{width, height, depth}, levels(levels), scratch(scratch),
+      capacity(std::max(memory / sizeof(Record), (std::size_t)1)), added(0)
+{
+    if ((levels == 0) || (levels > MAX_DEPTH))
+        throw std::invalid_argument("Chunk depth is out of range");
+
+    uint64_t cells = (uint64_t)width * height * depth;
+    if ((cells == 0) || (cells > (UINT64_MAX >> (3 * levels))))
+        throw std::invalid_argument("Chunk grid is too large");
+
+    buffer.reserve(capacity);
+}
+
+SVOBuilder::~SVOBuilder()
+{
+    for (const std::string &run : runs) std::remove(run.c_str());
+}
+
+uint32_t SVOBuilder::grid_width(void) const
+{
+    return size[0];
+}
+
+uint32_t SVOBuilder::grid_height(void) const
+{
+    return size[1];
+}
+
+uint32_t SVOBuilder::grid_depth(void) const
+{
+    return size[2];
+}
+
+uint32_t SVOBuilder::resolution(void) const
+{
+    return 1u << levels;
+}
+
+void SVOBuilder::add(uint32_t x, uint32_t y, uint32_t z, uint16_t material)
+{
+    uint32_t n = resolution();
+
+    if ((x / n >= size[0]) || (y / n >= size[1]) || (z / n >= size[2]))
+        throw std::out_of_range("Voxel is outside of the world");
+
+    uint64_t cell = ((uint64_t)(z / n) * size[1] + y / n) * size[0] + x / n;
+    uint64_t code = morton(x % n, y % n, z % n, levels);
+
+    buffer.push_back(Record{(cell << (3 * levels)) | code, material, 0});
+    if (buffer.size() == capacity) spill();
+    ++added;
+}
+
+std::size_t SVOBuilder::count(void) const
+{
+    return added;
+}
+
+void SVOBuilder::spill(void)
+{
+    std::sort(buffer.begin(), buffer.end());
+
+    runs.push_back(scratch + ".run" + std::to_string(runs.size()));
+    std::ofstream file(runs.back(), std::ios::binary | std::ios::trunc);
+    file.write((const char *)buffer.data(), buffer.size() * sizeof(Record));
+    if (!file) throw std::runtime_error("Failed to write '" + runs.back()
+                                      + "'");
+
+    buffer.clear();
+}
+
+/* Reads a sorted run back a block of records at a time. */
+template <typename Record>
+class RunReader
+{
+    public:
+        RunReader(const std::string &path, std::size_t records)
+            : file(path, std::ios::binary), block(records), pos(0)
+        {
+            if (!file)
+                throw std::runtime_error("Failed to open '" + path + "'");
+
+            block.clear();
+        }
+
+        /* Returns the next record, or nullptr at the end of the run. */
+        const Record *next(void)
+        {
+            if (pos == block.size())
+            {
+                block.resize(block.capacity());
+                file.read((char *)block.data(), block.size() * sizeof(Record));
+                block.resize((std::size_t)file.gcount() / sizeof(Record));
+                pos = 0;
+            }
+
+            return (pos < block.size()) ? &block[pos++] : nullptr;
+        }
+
+    private:
+        std::ifstream file;
+        std::vector<Record> block;
+        std::size_t pos;
+};
+
+std::size_t SVOBuilder::build(const std::string &path,
+                              std::size_t page_nodes)
+{
+    PageFile::Writer writer(path, page_nodes, size[0], size[1], size[2]);
+    std::function<bool(Record &)> next;
+    std::size_t buffered = 0;
+
+    std::vector<std::unique_ptr<RunReader<Record>>> readers;
+    std::vector<Record> heads; // the next record of each run, as a heap
+    auto after = [](const Record &a, const Record &b) { return b < a; };
+
+    /* Voxels which all fit in memory need not go through the disk at all. */
+    if (runs.empty())
+    {
+        std::sort(buffer.begin(), buffer.end());
+
+        next = [&](Record &record)
+        {
+            if (buffered == buffer.size()) return false;
+            record = buffer[buffered++];
+            return true;
+        };
+    }
+    else
+    {
+        if (!buffer.empty()) spill();
+        std::vector<Record>().swap(buffer); // the readers use the memory
+
+        std::size_t records = std::max(capacity / runs.size(),
+                                       (std::size_t)4096);
+
+        for (std::size_t t = 0; t < runs.size(); ++t)
+        {
+            readers.emplace_back(new RunReader<Record>(runs[t], records));
+
+            if (const Record *record = readers[t]->next())
+            {
+                heads.push_back(*record);
+                heads.back().run = (uint32_t)t;
+            }
+        }
+
+        std::make_heap(heads.begin(), heads.end(), after);
+
+        next = [&](Record &record)
+        {
+            if (heads.empty()) return false;
+
+            std::pop_heap(heads.begin(), heads.end(), after);
+            record = heads.back();
+            heads.pop_back();
+
+            if (const Record *following = readers[record.run]->next())
+            {
+                heads.push_back(*following);
+                heads.back().run = record.run;
+                std::push_heap(heads.begin(), heads.end(), after);
+            }
+
+            return true;
+        };
+    }
+
+    const uint64_t mask = (1ull << (3 * levels)) - 1;
+    uint64_t cell = UINT64_MAX, last = UINT64_MAX;
+    TreeBuilder tree(levels);
+
+    auto finish = [&](void)
+    {
+        const std::vector<Node> &nodes = tree.finish();
+        if (!nodes.empty()) writer.add((uint32_t)cell, nodes, 0);
+    };
+
+    Record record;
+
+    while (next(record))
+    {
+        if (record.key == last) continue; // added more than once
+        last = record.key;
+
+        if ((record.key >> (3 * levels)) != cell)
+        {
+            if (cell != UINT64_MAX) finish();
+
+            cell = record.key >> (3 * levels);
+            tree = TreeBuilder(levels);
+        }
+
+        tree.add(record.key & mask, (record.material == HIDDEN) ? HIDDEN_LEAF
+                                  : encode_leaf((uint16_t)record.material));
+    }
+
+    if (cell != UINT64_MAX) finish();
+
+    readers.clear();
+    for (const std::string &run : runs) std::remove(run.c_str());
+    runs.clear();
+    buffer.clear();
+
+    return writer.finish();
+}
@@ -0,0 +1,121 @@
+#include "geometry/generator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+Generator::Generator(uint16_t material)
+    : material(material)
+{
+
+}
+
+std::vector<Node> Generator::build(const aabb &cube, uint32_t levels) const
+{
+    if (levels == 0) throw std::invalid_argument("Octree has no levels");
+    std::vector<Node> nodes(1, Node{{0}}); // the root is always a node
+
+    for (std::size_t t = 0; t < 8; ++t)
+    {
+        uint32_t child = subtree(nodes, split_node(cube, t), levels - 1);
+        nodes[0].child[t] = child;
+    }
+
+    if (std::count(nodes[0].child, nodes[0].child + 8, 0u) == 8)
+        nodes.clear();
+
+    return nodes;
+}
+
+/* Builds the subtree within a cube, returning the child pointer to it. */
+uint32_t Generator::subtree(std::vector<Node> &nodes, const aabb &cube,
+                            uint32_t levels) const
+{
+    switch (classify(cube))
+    {
+        case Region::EMPTY: return 0;
+        case Region::SOLID: return encode_leaf(material);
+        default: break;
+    }
+
+    if (levels == 0)
+        return inside((cube.min + cube.max) * 0.5f) ? encode_leaf(material)
+                                                    : 0;
+
+    auto index = (uint32_t)nodes.size();
+    nodes.push_back(Node{{0}});
+    Node node; // as the nodes may move while building the children
+
+    for (std::size_t t = 0; t < 8; ++t)
+        node.child[t] = subtree(nodes, split_node(cube, t), levels - 1);
+
+    /* Merges nodes made up of the same leaf (i.e. all solid) into the leaf. */
+    if ((node.child[0] & LEAF_FLAG) && (std::count(node.child, node.child
+                                        + 8, node.child[0]) == 8))
+    {
+        nodes.resize(index);
+        return node.child[0];
+    }
+
+    /* Nodes with all their children pruned are not needed either. */
+    if (std::count(node.child, node.child + 8, 0u) == 8)
+    {
+        nodes.resize(index);
+        return 0;
+    }
+
+    nodes[index] = node;
+    return index;
+}
+
+HeightfieldGenerator::HeightfieldGenerator(const Height &height,
+                                           float slope_x, float slope_z,
+                                           uint16_t material)
+    : Generator(material), height(height), slope_x(slope_x), slope_z(slope_z)
+{
+
+}
+
+Generator::Region HeightfieldGenerator::classify(const aabb &box) const
+{
+    math::float3 center = (box.min + box.max) * 0.5f;
+    math::float3 extent = (box.max - box.min) * 0.5f;
+
+    /* The height can only differ from that at the center by this much. */
+    float h = height(center.x, center.z);
+    float bound = slope_x * extent.x + slope_z * extent.z;
+
+    if (box.min.y > h + bound) return Region::EMPTY;
+    if (box.max.y < h - bound) return Region::SOLID;
+    return Region::SURFACE;
+}
+
+bool HeightfieldGenerator::inside(const math::float3 &point) const
+{
+    return point.y <= height(point.x, point.z);
+}
+
+SDFGenerator::SDFGenerator(const Distance &distance, float lipschitz,
+                           uint16_t material)
+    : Generator(material), distance(distance), lipschitz(lipschitz)
+{
+
+}
+
+Generator::Region SDFGenerator::classify(const aabb &box) const
+{
+    math::float3 center = (box.min + box.max) * 0.5f;
+
+    /* No point of the box is further away from its center than a corner. */
+    float d = distance(center);
+    float bound = lipschitz * math::length((box.max - box.min) * 0.5f);
+
+    if (d > bound) return Region::EMPTY;
+    if (d < -bound) return Region::SOLID;
+    return Region::SURFACE;
+}
+
+bool SDFGenerator::inside(const math::float3 &point) const
+{
+    return distance(point) <= 0;
+}
@@ -0,0 +1,52 @@
+#include "geometry/hollow.hpp"
+
+#include <algorithm>
+
+/* The number of rows processed by each task (so each task does some work). */
+static const uint32_t ROW_BLOCK = 32;
+
+std::size_t hollow::row_words(uint32_t width)
+{
+    return ((std::size_t)width + 63) / 64;
+}
+
+void hollow::exposed(const uint64_t *below, const uint64_t *slab,
+                     const uint64_t *above, uint64_t *exposed, uint32_t width,
+                     uint32_t height, ThreadPool &pool)
+{
+    const std::size_t words = row_words(width);
+
+    pool.run((height + ROW_BLOCK - 1) / ROW_BLOCK, [&](std::size_t block)
+    {
+        auto first = (uint32_t)(block * ROW_BLOCK);
+        auto last = std::min(first + ROW_BLOCK, height);
+
+        for (uint32_t y = first; y < last; ++y)
+        {
+            const uint64_t *row = slab + y * words;
+            const uint64_t *prev = (y > 0) ? row - words : nullptr;
+            const uint64_t *next = (y + 1 < height) ? row + words : nullptr;
+            std::size_t offset = y * words;
+
+            for (std::size_t w = 0; w < words; ++w)
+            {
+                uint64_t solid = row[w];
+
+                /* Bit i of a word is voxel i of its 64, so the neighbours at *
+                 * x - 1 are shifted up, and those at x + 1 shifted down.    */
+                uint64_t left = (solid << 1) | ((w > 0) ? row[w - 1] >> 63
+                                                        : 0);
+                uint64_t right = (solid >> 1) | ((w + 1 < words)
+                                                 ? row[w + 1] << 63 : 0);
+
+                uint64_t inside = solid & left & right;
+                inside &= prev ? prev[w] : 0;
+                inside &= next ? next[w] : 0;
+                inside &= below ? below[offset + w] : 0;
+                inside &= above ? above[offset + w] : 0;
+
+                exposed[offset + w] = solid & ~inside;
+            }
+        }
+    });
+}
@@ -0,0 +1,120 @@
+#include "geometry/importer.hpp"
+#include "geometry/voxelizer.hpp"
+#include "geometry/builder.hpp"
+#include "geometry/volume.hpp"
+#include "geometry/mesh.hpp"
+
+#include "setup/thread_pool.hpp"
+#include "world/geometry.hpp"
+#include "gui/log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/* Returns the time elapsed since a given time, for progress messages. */
+static std::string elapsed(std::chrono::steady_clock::time_point since)
+{
+    std::chrono::duration<double> time = std::chrono::steady_clock::now()
+                                       - since;
+    return std::to_string((int)std::round(time.count() * 1000)) + " ms";
+}
+
+/* Builds the octrees of a world whose voxels were all added, and writes it. */
+static void write_world(SVOBuilder &builder, const std::string &path)
+{
+    auto begin = std::chrono::steady_clock::now();
+    std::size_t pages = builder.build(path, PagedGeometry::PAGE_NODES);
+    print_info("Wrote " + std::to_string(pages) + " pages to '" + path
+             + "' in " + elapsed(begin));
+}
+
+static bool import_mesh(const std::string &source, uint32_t depth,
+                        const std::string &path)
+{
+    auto begin = std::chrono::steady_clock::now();
+    Mesh mesh(source);
+    print_info("Loaded " + std::to_string(mesh.triangles().size())
+             + " triangles in " + elapsed(begin));
+
+    aabb bounds = mesh.bounds();
+    math::float3 size = bounds.max - bounds.min;
+    float longest = std::max(std::max(size.x, size.y), size.z);
+
+    if (!(longest > 0))
+    {
+        print_error("Mesh '" + source + "' is empty or flat");
+        return false;
+    }
+
+    /* The mesh's far sides are kept just inside of the last voxels. */
+    uint32_t levels = std::min(depth, importer::CHUNK_LEVELS);
+    float scale = ((1u << depth) - 0.5f) / longest;
+    uint32_t grid[3];
+
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+        double voxels = std::max(std::ceil((double)size[k] * scale), 1.0);
+        grid[k] = (uint32_t)std::ceil(voxels / (1u << levels));
+    }
+
+    ThreadPool pool;
+    SVOBuilder builder(grid[0], grid[1], grid[2], levels, path);
+
+    begin = std::chrono::steady_clock::now();
+    std::size_t voxels = voxelizer::run(mesh, bounds.min, scale, builder,
+                                        pool);
+    print_info("Voxelized " + std::to_string(voxels) + " voxels in "
+             + elapsed(begin) + " (" + std::to_string(pool.size())
+             + " threads)");
+
+    write_world(builder, path);
+    return true;
+}
+
+static bool import_volume(const std::string &source, uint32_t depth,
+                          const std::string &path, bool hide_interior)
+{
+    Volume volume(source);
+    const uint32_t size[3] = {volume.width(), volume.height(),
+                              volume.depth()};
+
+    if (std::max(std::max(size[0], size[1]), size[2]) > (1u << depth))
+    {
+        print_error("Volume '" + source + "' does not fit in a world of "
+                    "depth " + std::to_string(depth));
+        return false;
+    }
+
+    uint32_t levels = std::min(depth, importer::CHUNK_LEVELS);
+    uint32_t n = 1u << levels, grid[3];
+    for (std::size_t k = 0; k < 3; ++k)
+        grid[k] = std::max((size[k] + n - 1) / n, 1u);
+
+    ThreadPool pool;
+    SVOBuilder builder(grid[0], grid[1], grid[2], levels, path);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::size_t voxels = volume.stream(builder, pool, hide_interior);
+    print_info("Read " + std::to_string(voxels) + " voxels ("
+             + std::to_string(size[0]) + "x" + std::to_string(size[1])
+             + "x" + std::to_string(size[2]) + ") in " + elapsed(begin));
+
+    write_world(builder, path);
+    return true;
+}
+
+bool importer::run(const std::string &source, uint32_t depth,
+                   const std::string &path, bool hide_interior)
+{
+    if ((depth == 0) || (depth > MAX_DEPTH))
+    {
+        print_error("World depth must be between 1 and "
+                  + std::to_string(MAX_DEPTH));
+        return false;
+    }
+
+    if (Volume::supports(source))
+        return import_volume(source, depth, path, hide_interior);
+    else return import_mesh(source, depth, path);
+}
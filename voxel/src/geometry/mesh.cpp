@@ -0,0 +1,366 @@
+#include "geometry/mesh.hpp"
+#include "geometry/formats.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <map>
+
+Mesh::Mesh(const std::string &path)
+{
+    if (has_extension(path, ".obj")) load_obj(path);
+    else if (has_extension(path, ".ply")) load_ply(path);
+    else throw std::runtime_error("Unknown mesh format '" + path + "'");
+
+    for (const Triangle &triangle : triangle_list)
+        for (uint32_t index : triangle.vertex)
+            if (index >= vertex_list.size())
+                throw std::runtime_error("Vertex index out of range in '"
+                                       + path + "'");
+}
+
+const std::vector<math::float3> &Mesh::vertices(void) const
+{
+    return vertex_list;
+}
+
+const std::vector<Mesh::Triangle> &Mesh::triangles(void) const
+{
+    return triangle_list;
+}
+
+const std::vector<std::string> &Mesh::materials(void) const
+{
+    return material_list;
+}
+
+aabb Mesh::bounds(void) const
+{
+    if (triangle_list.empty())
+        return aabb{math::float3(0, 0, 0), math::float3(0, 0, 0)};
+
+    const math::float3 &first = vertex_list[triangle_list[0].vertex[0]];
+    aabb box{first, first};
+
+    for (const Triangle &triangle : triangle_list)
+        for (uint32_t index : triangle.vertex)
+        {
+            box.min = std::min(box.min, vertex_list[index]);
+            box.max = std::max(box.max, vertex_list[index]);
+        }
+
+    return box;
+}
+
+void Mesh::add_polygon(const std::vector<uint32_t> &polygon,
+                       uint32_t material)
+{
+    for (std::size_t t = 2; t < polygon.size(); ++t)
+        triangle_list.push_back(Triangle{{polygon[0], polygon[t - 1],
+                                          polygon[t]}, (uint16_t)material});
+}
+
+void Mesh::load_obj(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Failed to open '" + path + "'");
+
+    std::map<std::string, uint32_t> ids;
+    std::vector<uint32_t> polygon;
+    uint32_t material = 0;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        const char *p = line.c_str();
+        while (isspace(*p)) ++p;
+
+        if ((p[0] == 'v') && isspace(p[1]))
+        {
+            char *end;
+            float x = strtof(p + 1, &end);
+            float y = strtof(end, &end);
+            float z = strtof(end, &end);
+            vertex_list.push_back(math::float3(x, y, z));
+        }
+        else if ((p[0] == 'f') && isspace(p[1]))
+        {
+            polygon.clear();
+            ++p;
+
+            while (true)
+            {
+                char *end;
+                long index = strtol(p, &end, 10);
+                if (end == p) break;
+
+                /* Negative indices count back from the last vertex read. */
+                if (index < 0) index += (long)vertex_list.size();
+                else --index;
+
+                if (index < 0)
+                    throw std::runtime_error("Bad face in '" + path + "'");
+
+                polygon.push_back((uint32_t)index);
+
+                /* Texture coordinate and normal indices are skipped over. */
+                for (p = end; *p && !isspace(*p); ++p) { }
+            }
+
+            add_polygon(polygon, material);
+        }
+        else if (!strncmp(p, "usemtl", 6) && isspace(p[6]))
+        {
+            std::string name(p + 7);
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t\r") + 1);
+
+            auto id = ids.find(name);
+
+            if (id == ids.end())
+            {
+                if (material_list.size() == MAX_MATERIALS)
+                    throw std::runtime_error("Too many materials in '"
+                                           + path + "'");
+
+                material_list.push_back(name);
+                id = ids.emplace(name, (uint32_t)material_list.size()).first;
+            }
+
+            material = id->second;
+        }
+    }
+}
+
+/* The type of a PLY property, resolved from its name in the header. */
+struct PLYType
+{
+    char kind; // 'i', 'u' or 'f'
+    std::size_t size;
+
+    explicit PLYType(const std::string &name = "uchar")
+    {
+        static const std::map<std::string, PLYType> types =
+        {
+            {"char",  {'i', 1}}, {"uchar",  {'u', 1}}, {"int8",    {'i', 1}},
+            {"uint8", {'u', 1}}, {"short",  {'i', 2}}, {"ushort",  {'u', 2}},
+            {"int16", {'i', 2}}, {"uint16", {'u', 2}}, {"int",     {'i', 4}},
+            {"uint",  {'u', 4}}, {"int32",  {'i', 4}}, {"uint32",  {'u', 4}},
+            {"float", {'f', 4}}, {"double", {'f', 8}}, {"float32", {'f', 4}},
+            {"float64", {'f', 8}},
+        };
+
+        auto type = types.find(name);
+        if (type == types.end())
+            throw std::runtime_error("Unknown PLY type '" + name + "'");
+
+        *this = type->second;
+    }
+
+    PLYType(char kind, std::size_t size) : kind(kind), size(size) { }
+};
+
+/* What a property is used for, as far as the mesh is concerned. */
+enum class PLYRole { NONE, X, Y, Z, MATERIAL, INDICES };
+
+struct PLYProperty
+{
+    PLYType type, count_type;
+    bool list;
+    PLYRole role;
+};
+
+struct PLYElement
+{
+    std::string name;
+    std::size_t count;
+    std::vector<PLYProperty> properties;
+};
+
+/* Reads a value of any type from a PLY file, converting it to a double. */
+class PLYReader
+{
+    public:
+        PLYReader(std::ifstream &file, const std::string &format)
+            : file(file), ascii(format == "ascii")
+        {
+            const uint16_t probe = 1;
+            bool little_endian = *(const uint8_t *)&probe;
+
+            if (!ascii && (format != "binary_little_endian")
+                       && (format != "binary_big_endian"))
+                throw std::runtime_error("Unknown PLY format '"
+                                       + format + "'");
+
+            swap = little_endian != (format == "binary_little_endian");
+        }
+
+        double read(const PLYType &type)
+        {
+            if (ascii)
+            {
+                double value;
+                if (!(file >> value)) throw std::runtime_error("Truncated");
+                return value;
+            }
+
+            unsigned char bytes[8];
+
+            if (!file.read((char *)bytes, type.size))
+                throw std::runtime_error("Truncated");
+            if (swap) std::reverse(bytes, bytes + type.size);
+
+            switch (type.kind * 16 + type.size)
+            {
+                case 'i' * 16 + 1: return as<int8_t>(bytes);
+                case 'u' * 16 + 1: return as<uint8_t>(bytes);
+                case 'i' * 16 + 2: return as<int16_t>(bytes);
+                case 'u' * 16 + 2: return as<uint16_t>(bytes);
+                case 'i' * 16 + 4: return as<int32_t>(bytes);
+                case 'u' * 16 + 4: return as<uint32_t>(bytes);
+                case 'f' * 16 + 4: return as<float>(bytes);
+                default:           return as<double>(bytes);
+            }
+        }
+
+    private:
+        std::ifstream &file;
+        bool ascii, swap;
+
+        template <typename T> static double as(const unsigned char *bytes)
+        {
+            T value;
+            memcpy(&value, bytes, sizeof(T));
+            return (double)value;
+        }
+};
+
+static PLYRole ply_role(const std::string &element, const std::string &name)
+{
+    if (element == "vertex")
+    {
+        if (name == "x") return PLYRole::X;
+        if (name == "y") return PLYRole::Y;
+        if (name == "z") return PLYRole::Z;
+    }
+    else if (element == "face")
+    {
+        if (name == "material_index") return PLYRole::MATERIAL;
+        if ((name == "vertex_indices") || (name == "vertex_index"))
+            return PLYRole::INDICES;
+    }
+
+    return PLYRole::NONE;
+}
+
+void Mesh::load_ply(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open '" + path + "'");
+
+    std::vector<PLYElement> elements;
+    std::string line, format;
+
+    if (!std::getline(file, line) || (line.compare(0, 3, "ply") != 0))
+        throw std::runtime_error("Not a PLY file '" + path + "'");
+
+    try
+    {
+        while (std::getline(file, line))
+        {
+            std::istringstream words(line);
+            std::string keyword, type, name;
+            words >> keyword;
+
+            if (keyword == "format") words >> format;
+            else if (keyword == "element")
+            {
+                elements.push_back(PLYElement());
+                words >> elements.back().name >> elements.back().count;
+            }
+            else if ((keyword == "property") && !elements.empty())
+            {
+                PLYProperty property;
+                words >> type;
+
+                if ((property.list = (type == "list")))
+                {
+                    words >> type;
+                    property.count_type = PLYType(type);
+                    words >> type;
+                }
+
+                words >> name;
+                property.type = PLYType(type);
+                property.role = ply_role(elements.back().name, name);
+                elements.back().properties.push_back(property);
+            }
+            else if (keyword == "end_header") break;
+        }
+
+        PLYReader reader(file, format);
+        std::vector<uint32_t> polygon;
+
+        for (const PLYElement &element : elements)
+            for (std::size_t n = 0; n < element.count; ++n)
+            {
+                math::float3 vertex(0, 0, 0);
+                uint32_t material = 0;
+                polygon.clear();
+
+                for (const PLYProperty &property : element.properties)
+                {
+                    if (property.list)
+                    {
+                        auto count = (std::size_t)reader.read(
+                                                       property.count_type);
+
+                        for (std::size_t t = 0; t < count; ++t)
+                        {
+                            double index = reader.read(property.type);
+
+                            if (property.role == PLYRole::INDICES)
+                                polygon.push_back((uint32_t)index);
+                        }
+
+                        continue;
+                    }
+
+                    double value = reader.read(property.type);
+
+                    switch (property.role)
+                    {
+                        case PLYRole::X: vertex.x = (float)value; break;
+                        case PLYRole::Y: vertex.y = (float)value; break;
+                        case PLYRole::Z: vertex.z = (float)value; break;
+                        case PLYRole::MATERIAL:
+                            material = (uint32_t)value + 1;
+                            break;
+                        default: break;
+                    }
+                }
+
+                if (element.name == "vertex") vertex_list.push_back(vertex);
+                else if (element.name == "face")
+                {
+                    if (material > MAX_MATERIALS)
+                        throw std::runtime_error("Too many materials");
+
+                    while (material_list.size() < material)
+                        material_list.push_back(
+                            std::to_string(material_list.size()));
+
+                    add_polygon(polygon, material);
+                }
+            }
+    }
+    catch (const std::runtime_error &e)
+    {
+        throw std::runtime_error(std::string(e.what()) + " in '"
+                               + path + "'");
+    }
+}
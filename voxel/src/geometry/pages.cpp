@@ -0,0 +1,407 @@
+#include "geometry/pages.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <deque>
+
+const uint32_t PageFile::NO_PAGE;
+const uint32_t PageFile::NO_ENTRY;
+
+static const char MAGIC[8] = {'V', 'X', 'P', 'A', 'G', 'E', 'S', '6'};
+
+/* Each page is compressed as the number of nodes in use (the rest of them  *
+ * being empty), then for each node a byte whose bits say which children are *
+ * not empty, each followed by a varint. Its two low bits give the kind of   *
+ * pointer, and the others hold the zigzagged difference from the previous  *
+ * pointer of that kind in the page: as pages are filled breadth-first, node *
+ * pointers mostly increase by one, while adjacent leaves share materials.   */
+
+enum Kind
+{
+    NODE = 0,
+    LEAF = 1,
+    PAGE = 2,
+    RAW  = 3, // leaves with any of the low bits set, stored as they are
+};
+
+static uint64_t zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void put_varint(std::vector<uint8_t> &out, uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7) out.push_back((uint8_t)value | 0x80);
+    out.push_back((uint8_t)value);
+}
+
+static uint64_t get_varint(const uint8_t *&p, const uint8_t *end)
+{
+    uint64_t value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (p == end) break;
+        uint8_t byte = *p++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+
+    throw std::runtime_error("Page is corrupt");
+}
+
+static void encode(const std::vector<Node> &page, std::size_t used,
+                   std::vector<uint8_t> &out)
+{
+    int64_t last[3] = {0, 0, 0}; // per kind
+    out.clear();
+    put_varint(out, used);
+
+    for (std::size_t t = 0; t < used; ++t)
+    {
+        uint8_t mask = 0;
+        for (uint32_t c = 0; c < 8; ++c)
+            if (page[t].child[c] != 0) mask |= (uint8_t)(1 << c);
+        out.push_back(mask);
+
+        for (uint32_t child : page[t].child)
+        {
+            if (child == 0) continue;
+
+            Kind kind = (child & LEAF_FLAG) ? ((child & 0xFFFF) ? RAW : LEAF)
+                      : (child & PAGE_FLAG) ? PAGE : NODE;
+
+            if (kind == RAW)
+            {
+                put_varint(out, ((uint64_t)child << 2) | RAW);
+                continue;
+            }
+
+            int64_t value = (kind == LEAF) ? (child >> 16) & 0x7FFF
+                          : (kind == PAGE) ? child ^ PAGE_FLAG : child;
+            put_varint(out, (zigzag(value - last[kind]) << 2) | kind);
+            last[kind] = value;
+        }
+    }
+}
+
+/* Returns the info of a page whose cube is that of a node (without any *
+ * subtrees yet).                                                       */
+static PageFile::PageInfo page_info(uint32_t parent, uint32_t node,
+                                    const PageFile::PageInfo &cube)
+{
+    PageFile::PageInfo info{parent, node, cube.tree, cube.level,
+                            cube.x, cube.y, cube.z, {0}};
+    std::fill(info.entry, info.entry + 8, PageFile::NO_ENTRY);
+    return info;
+}
+
+/* Returns the cube of a child of a node's cube (as offset in geometry.cl). */
+static PageFile::PageInfo child_cube(const PageFile::PageInfo &cube,
+                                     uint32_t child)
+{
+    PageFile::PageInfo info = page_info(PageFile::NO_PAGE, 0, cube);
+    info.level = cube.level + 1;
+    info.x = cube.x * 2 + ((child >> 2) & 1);
+    info.y = cube.y * 2 + ((child >> 1) & 1);
+    info.z = cube.z * 2 + ((child >> 0) & 1);
+    return info;
+}
+
+/* Returns the number of nodes of a node's subtree which stay in its page, *
+ * cutting off its largest child subtrees (into other pages) until they fit *
+ * in one. Doing so bottom-up cuts the tree into as few subtrees as can be  *
+ * (Kundu and Misra, 1977), the subtrees cut off being as large as can be.  */
+static uint32_t measure(const std::vector<Node> &nodes, uint32_t n,
+                        uint32_t capacity, std::vector<uint32_t> &kept,
+                        std::vector<uint8_t> &cut)
+{
+    uint32_t size = 1;
+
+    for (uint32_t child : nodes[n].child)
+        if (is_node(child))
+            size += measure(nodes, child, capacity, kept, cut);
+
+    while (size > capacity)
+    {
+        uint32_t largest = 8;
+
+        for (uint32_t c = 0; c < 8; ++c)
+        {
+            uint32_t child = nodes[n].child[c];
+            if (!is_node(child) || (cut[n] & (1 << c))) continue;
+
+            if ((largest == 8)
+             || (kept[child] > kept[nodes[n].child[largest]])) largest = c;
+        }
+
+        cut[n] |= (uint8_t)(1 << largest);
+        size -= kept[nodes[n].child[largest]];
+    }
+
+    return kept[n] = size;
+}
+
+PageFile::Writer::Writer(const std::string &path, std::size_t page_nodes,
+                         uint32_t width, uint32_t height, uint32_t depth)
+    : file(path, std::ios::binary | std::ios::trunc),
+      cells(width * height * depth, NO_PAGE)
+{
+    if (!file) throw std::runtime_error("Failed to create '" + path + "'");
+
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.page_nodes = (uint32_t)page_nodes;
+    header.page_count = 0;
+    header.grid[0] = width;
+    header.grid[1] = height;
+    header.grid[2] = depth;
+    header.padding = 0;
+    header.index_offset = 0;
+    file.write((const char *)&header, sizeof(header));
+}
+
+uint32_t PageFile::Writer::add(uint32_t cell, const std::vector<Node> &nodes,
+                               uint32_t root)
+{
+    const uint32_t capacity = header.page_nodes;
+    std::vector<uint32_t> kept(nodes.size());
+    std::vector<uint8_t> cut(nodes.size(), 0); // child mask, per node
+    measure(nodes, root, capacity, kept, cut);
+
+    const uint32_t base = (uint32_t)index.size(); // the root page's ID
+    index.push_back(page_info(NO_PAGE, 0, PageInfo{0, 0, base, 0, 0, 0, 0,
+                                                   {0}}));
+    cells.at(cell) = base;
+
+    /* The subtrees of each of the tree's pages (in page ID order, which is *
+     * the order pages are cut off in), as their first node and its cube, and *
+     * which child of the page's node it is.                                 */
+    struct Subtree
+    {
+        uint32_t node, child;
+        PageInfo cube;
+    };
+
+    std::vector<std::vector<Subtree>> subtrees{{Subtree{root, 0,
+                                                        index.back()}}};
+    std::vector<Node> page(capacity);
+
+    for (uint32_t p = 0; p < subtrees.size(); ++p)
+    {
+        std::unordered_map<uint32_t, uint32_t> local;
+        std::vector<uint32_t> members;
+        std::vector<PageInfo> cube; // of each member (only the cube is used)
+        std::deque<std::pair<uint32_t, PageInfo>> frontier;
+
+        for (const Subtree &subtree : subtrees[p])
+        {
+            index[base + p].entry[subtree.child] = (uint32_t)frontier.size();
+            frontier.emplace_back(subtree.node, subtree.cube);
+        }
+
+        while (!frontier.empty())
+        {
+            uint32_t n = frontier.front().first;
+            local[n] = (uint32_t)members.size();
+            members.push_back(n);
+            cube.push_back(frontier.front().second);
+            frontier.pop_front();
+
+            for (uint32_t c = 0; c < 8; ++c)
+                if (is_node(nodes[n].child[c]) && !(cut[n] & (1 << c)))
+                    frontier.emplace_back(nodes[n].child[c],
+                                          child_cube(cube.back(), c));
+        }
+
+        /* The subtrees are placed breadth-first one after the other, so the *
+         * first ones are found at the start of the page.                    */
+        std::fill(page.begin(), page.end(), Node{{0}});
+
+        for (uint32_t t = 0; t < members.size(); ++t)
+        {
+            const Node &node = nodes[members[t]];
+
+            for (uint32_t c = 0; c < 8; ++c)
+                if (!is_node(node.child[c])) page[t].child[c] = node.child[c];
+                else if (!(cut[members[t]] & (1 << c)))
+                    page[t].child[c] = local[node.child[c]];
+
+            /* The subtrees cut off from the node are packed into pages, *
+             * first fit decreasing (the cube of a page holding more than *
+             * one of them being the node's cube).                        */
+            std::vector<uint32_t> order;
+            for (uint32_t c = 0; c < 8; ++c)
+                if (cut[members[t]] & (1 << c)) order.push_back(c);
+
+            std::stable_sort(order.begin(), order.end(),
+                             [&](uint32_t a, uint32_t b)
+                             { return kept[node.child[a]]
+                                    > kept[node.child[b]]; });
+
+            std::vector<uint32_t> shared, used; // page IDs and nodes in use
+
+            for (uint32_t c : order)
+            {
+                uint32_t size = kept[node.child[c]], bin = 0;
+                while ((bin < shared.size()) && (used[bin] + size > capacity))
+                    ++bin;
+
+                if (bin == shared.size())
+                {
+                    shared.push_back((uint32_t)index.size());
+                    used.push_back(0);
+                    index.push_back(page_info(base + p, t,
+                                              child_cube(cube[t], c)));
+                    subtrees.emplace_back();
+                }
+                else
+                {
+                    PageInfo &info = index[shared[bin]];
+                    info.level = cube[t].level;
+                    info.x = cube[t].x;
+                    info.y = cube[t].y;
+                    info.z = cube[t].z;
+                }
+
+                used[bin] += size;
+                page[t].child[c] = shared[bin] | PAGE_FLAG;
+                subtrees[shared[bin] - base].push_back(
+                    Subtree{node.child[c], c, child_cube(cube[t], c)});
+            }
+        }
+
+        encode(page, members.size(), data);
+        extents.push_back(Extent{(uint64_t)file.tellp(),
+                                 (uint32_t)data.size(), 0});
+        file.write((const char *)data.data(), data.size());
+    }
+
+    if (!file) throw std::runtime_error("Failed to write page file");
+    return base;
+}
+
+std::size_t PageFile::Writer::finish(void)
+{
+    header.page_count = (uint32_t)index.size();
+    header.index_offset = (uint64_t)file.tellp();
+    file.write((const char *)index.data(), index.size() * sizeof(PageInfo));
+    file.write((const char *)extents.data(), extents.size() * sizeof(Extent));
+    file.write((const char *)cells.data(), cells.size() * sizeof(uint32_t));
+    file.seekp(0);
+    file.write((const char *)&header, sizeof(header));
+    file.close();
+
+    if (!file) throw std::runtime_error("Failed to write page file");
+    return index.size();
+}
+
+PageFile::PageFile(const std::string &path)
+    : file(path, std::ios::binary)
+{
+    file.read((char *)&header, sizeof(header));
+
+    if (!file || memcmp(header.magic, MAGIC, sizeof(MAGIC)))
+        throw std::runtime_error("'" + path + "' is not a page file");
+
+    index.resize(header.page_count);
+    extents.resize(header.page_count);
+    cells.resize(header.grid[0] * header.grid[1] * header.grid[2]);
+    file.seekg(header.index_offset);
+    file.read((char *)index.data(), index.size() * sizeof(PageInfo));
+    file.read((char *)extents.data(), extents.size() * sizeof(Extent));
+    file.read((char *)cells.data(), cells.size() * sizeof(uint32_t));
+    if (!file) throw std::runtime_error("'" + path + "' is truncated");
+}
+
+std::size_t PageFile::page_nodes(void) const
+{
+    return header.page_nodes;
+}
+
+std::size_t PageFile::page_count(void) const
+{
+    return header.page_count;
+}
+
+uint32_t PageFile::grid_width(void) const
+{
+    return header.grid[0];
+}
+
+uint32_t PageFile::grid_height(void) const
+{
+    return header.grid[1];
+}
+
+uint32_t PageFile::grid_depth(void) const
+{
+    return header.grid[2];
+}
+
+uint32_t PageFile::chunk(uint32_t cell) const
+{
+    return cells.at(cell);
+}
+
+const PageFile::PageInfo &PageFile::info(uint32_t page) const
+{
+    return index.at(page);
+}
+
+void PageFile::read(uint32_t page, std::vector<uint8_t> &data)
+{
+    if (page >= header.page_count)
+        throw std::out_of_range("Page ID out of range");
+
+    data.resize(extents[page].size);
+    file.seekg(extents[page].offset);
+    file.read((char *)data.data(), data.size());
+    if (!file) throw std::runtime_error("Failed to read page");
+}
+
+std::size_t PageFile::decode(const std::vector<uint8_t> &data,
+                             Node *nodes) const
+{
+    const uint8_t *p = data.data(), *end = p + data.size();
+    int64_t last[3] = {0, 0, 0}; // per kind
+
+    uint64_t used = get_varint(p, end);
+    if (used > header.page_nodes) throw std::runtime_error("Page is corrupt");
+    std::fill(nodes, nodes + header.page_nodes, Node{{0}});
+
+    for (uint64_t t = 0; t < used; ++t)
+    {
+        if (p == end) throw std::runtime_error("Page is corrupt");
+        uint8_t mask = *p++;
+
+        for (uint32_t c = 0; c < 8; ++c)
+        {
+            if (!(mask & (1 << c))) continue;
+
+            uint64_t code = get_varint(p, end);
+            Kind kind = (Kind)(code & 3);
+
+            if (kind == RAW)
+            {
+                nodes[t].child[c] = (uint32_t)(code >> 2);
+                continue;
+            }
+
+            int64_t value = last[kind] + unzigzag(code >> 2);
+            last[kind] = value;
+
+            nodes[t].child[c] = (kind == LEAF) ? encode_leaf((uint16_t)value)
+                              : (kind == PAGE) ? (uint32_t)value | PAGE_FLAG
+                              : (uint32_t)value;
+        }
+    }
+
+    return used;
+}
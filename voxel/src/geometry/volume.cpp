@@ -0,0 +1,428 @@
+#include "geometry/volume.hpp"
+#include "geometry/hollow.hpp"
+#include "geometry/formats.hpp"
+#include "gui/log.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <sstream>
+#include <cctype>
+#include <regex>
+#include <map>
+
+/* The number of voxels of a .vox model read at once. */
+static const std::size_t VOX_BLOCK = 1 << 16;
+
+Volume::Volume(const std::string &path)
+    : path(path), file(path, std::ios::binary), value_bytes(0)
+{
+    if (!file) throw std::runtime_error("Failed to open '" + path + "'");
+
+    if (has_extension(path, ".raw")) open_raw();
+    else if (has_extension(path, ".vox")) open_vox();
+    else throw std::runtime_error("Unknown volume format '" + path + "'");
+}
+
+bool Volume::supports(const std::string &path)
+{
+    return has_extension(path, ".raw") || has_extension(path, ".vox");
+}
+
+uint32_t Volume::width(void) const
+{
+    return size[0];
+}
+
+uint32_t Volume::height(void) const
+{
+    return size[1];
+}
+
+uint32_t Volume::depth(void) const
+{
+    return size[2];
+}
+
+std::size_t Volume::stream(SVOBuilder &builder, ThreadPool &pool,
+                           bool hide_interior)
+{
+    if (value_bytes > 0) return stream_raw(builder, pool, hide_interior);
+    else return stream_vox(builder, pool, hide_interior);
+}
+
+void Volume::open_raw(void)
+{
+    std::string name = path.substr(path.find_last_of("/\\") + 1);
+    std::smatch match;
+
+    if (!std::regex_search(name, match, std::regex("(\\d+)x(\\d+)x(\\d+)")))
+        throw std::runtime_error("No dimensions in the name of '"
+                               + path + "'");
+
+    for (std::size_t k = 0; k < 3; ++k)
+        size[k] = (uint32_t)strtoul(match[k + 1].str().c_str(), nullptr, 10);
+
+    file.seekg(0, std::ios::end);
+    auto bytes = (uint64_t)file.tellg();
+    file.seekg(0);
+
+    uint64_t voxels = (uint64_t)size[0] * size[1] * size[2];
+    if ((voxels > 0) && (bytes == voxels)) value_bytes = 1;
+    else if ((voxels > 0) && (bytes == voxels * 2)) value_bytes = 2;
+    else throw std::runtime_error("Size of '" + path + "' does not match "
+                                  "its dimensions");
+}
+
+std::size_t Volume::stream_raw(SVOBuilder &builder, ThreadPool &pool,
+                               bool hide_interior)
+{
+    const std::size_t words = hollow::row_words(size[0]);
+    const std::size_t slab_words = words * size[1];
+
+    /* The values of this slab and the next, and the occupancy of the slabs *
+     * around this one, which are all needed to find its exposed voxels.    */
+    std::vector<uint8_t> values[2];
+    std::vector<uint64_t> solid[3], exposed(slab_words);
+    for (auto &slab : values) slab.resize((std::size_t)size[0] * size[1]
+                                                     * value_bytes);
+    for (auto &slab : solid) slab.resize(slab_words);
+
+    auto value = [&](const std::vector<uint8_t> &slab, std::size_t t)
+    {
+        uint32_t v = slab[t * value_bytes];
+        if (value_bytes == 2) v |= (uint32_t)slab[t * value_bytes + 1] << 8;
+        return v;
+    };
+
+    auto load = [&](std::vector<uint8_t> &slab, std::vector<uint64_t> &bits)
+    {
+        if (!file.read((char *)slab.data(), slab.size()))
+            throw std::runtime_error("Failed to read '" + path + "'");
+
+        std::fill(bits.begin(), bits.end(), 0);
+
+        for (uint32_t y = 0; y < size[1]; ++y)
+            for (uint32_t x = 0; x < size[0]; ++x)
+                if (value(slab, (std::size_t)y * size[0] + x) != 0)
+                    bits[y * words + x / 64] |= 1ull << (x % 64);
+    };
+
+    std::size_t added = 0;
+    load(values[0], solid[1]);
+
+    for (uint32_t z = 0; z < size[2]; ++z)
+    {
+        bool last = (z + 1 == size[2]);
+        if (!last) load(values[1], solid[2]);
+
+        if (!hide_interior) exposed = solid[1];
+        else hollow::exposed((z > 0) ? solid[0].data() : nullptr,
+                             solid[1].data(),
+                             !last ? solid[2].data() : nullptr,
+                             exposed.data(), size[0], size[1], pool);
+
+        for (uint32_t y = 0; y < size[1]; ++y)
+            for (std::size_t w = 0; w < words; ++w)
+                for (uint64_t bits = solid[1][y * words + w]; bits != 0;
+                     bits &= bits - 1)
+                {
+                    int bit = __builtin_ctzll(bits);
+                    auto x = (uint32_t)(w * 64 + bit);
+                    uint32_t material = value(values[0],
+                                              (std::size_t)y * size[0] + x);
+
+                    if (!(exposed[y * words + w] & (1ull << bit)))
+                        material = SVOBuilder::HIDDEN;
+                    else material = std::min(material, 0x7FFFu);
+
+                    builder.add(x, y, z, (uint16_t)material);
+                    ++added;
+                }
+
+        std::swap(values[0], values[1]);
+        std::swap(solid[0], solid[1]);
+        std::swap(solid[1], solid[2]);
+    }
+
+    return added;
+}
+
+static uint32_t read_u32(std::ifstream &file)
+{
+    uint8_t bytes[4];
+    if (!file.read((char *)bytes, 4)) throw std::runtime_error("Truncated");
+
+    return (uint32_t)bytes[0]       | ((uint32_t)bytes[1] << 8)
+         | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static std::string read_string(std::ifstream &file)
+{
+    std::string str(read_u32(file), '\0');
+    if (!file.read(&str[0], str.size()))
+        throw std::runtime_error("Truncated");
+
+    return str;
+}
+
+static std::map<std::string, std::string> read_dict(std::ifstream &file)
+{
+    std::map<std::string, std::string> dict;
+
+    for (uint32_t count = read_u32(file); count > 0; --count)
+    {
+        std::string key = read_string(file);
+        dict[key] = read_string(file);
+    }
+
+    return dict;
+}
+
+/* A node of a .vox file's scene graph (a transform, group or shape). */
+struct VoxNode
+{
+    char type; // 'T', 'G' or 'S'
+    int32_t translation[3];
+    std::vector<uint32_t> children; // or models, for shapes
+};
+
+void Volume::open_vox(void)
+{
+    std::vector<std::vector<int32_t>> model_sizes;
+    std::map<uint32_t, VoxNode> nodes;
+    bool rotated = false;
+    char id[4];
+
+    try
+    {
+        if (!file.read(id, 4) || strncmp(id, "VOX ", 4))
+            throw std::runtime_error("Not a .vox file");
+        read_u32(file); // version
+
+        /* The MAIN chunk has no content, with every other chunk its child. */
+        if (!file.read(id, 4) || strncmp(id, "MAIN", 4))
+            throw std::runtime_error("No MAIN chunk");
+        uint32_t main_content = read_u32(file);
+        read_u32(file); // size of the children
+        file.seekg(main_content, std::ios::cur);
+
+        while (file.read(id, 4))
+        {
+            uint32_t content = read_u32(file), children = read_u32(file);
+            auto start = file.tellg();
+            std::string chunk(id, 4);
+
+            if (chunk == "SIZE")
+            {
+                std::vector<int32_t> dims(3);
+                for (int32_t &dim : dims) dim = (int32_t)read_u32(file);
+                model_sizes.push_back(dims);
+            }
+            else if (chunk == "XYZI")
+            {
+                uint32_t count = read_u32(file);
+                models.push_back(Model{(uint64_t)file.tellg(), count});
+            }
+            else if ((chunk == "nTRN") || (chunk == "nGRP")
+                                       || (chunk == "nSHP"))
+            {
+                VoxNode &node = nodes[read_u32(file)];
+                node.type = chunk[1];
+                std::fill(node.translation, node.translation + 3, 0);
+                read_dict(file); // node attributes
+
+                if (node.type == 'T')
+                {
+                    node.children.push_back(read_u32(file));
+                    read_u32(file); // reserved
+                    read_u32(file); // layer
+                    uint32_t frames = read_u32(file);
+
+                    /* Only the first frame's transform is of interest. */
+                    for (uint32_t f = 0; f < frames; ++f)
+                    {
+                        auto frame = read_dict(file);
+                        if (f > 0) continue;
+
+                        std::istringstream t(frame["_t"]);
+                        t >> node.translation[0] >> node.translation[1]
+                          >> node.translation[2];
+
+                        if (frame.count("_r") && (frame["_r"] != "4"))
+                            rotated = true; // 4 is the identity
+                    }
+                }
+                else for (uint32_t n = read_u32(file); n > 0; --n)
+                {
+                    node.children.push_back(read_u32(file));
+                    if (node.type == 'S') read_dict(file); // model attributes
+                }
+            }
+
+            file.seekg(start + (std::streamoff)((uint64_t)content + children));
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        throw std::runtime_error(std::string(e.what()) + " in '"
+                               + path + "'");
+    }
+
+    if (models.empty() || (models.size() != model_sizes.size()))
+        throw std::runtime_error("No models in '" + path + "'");
+
+    if (rotated) print_warning("Model rotations in '" + path + "' are "
+                               "not supported, and were ignored");
+
+    /* Models are centered on their translation (older files do not have a *
+     * scene graph, in which case they are simply placed at the origin).   */
+    if (nodes.empty())
+        for (uint32_t m = 0; m < models.size(); ++m)
+            instances.push_back(Instance{m, {0, 0, 0}});
+
+    std::function<void(uint32_t, const int32_t *, int)> place;
+    place = [&](uint32_t id, const int32_t *offset, int level)
+    {
+        auto node = nodes.find(id);
+        if ((node == nodes.end()) || (level > 64)) return; // or a cycle
+
+        int32_t translation[3];
+        for (std::size_t k = 0; k < 3; ++k)
+            translation[k] = offset[k] + node->second.translation[k];
+
+        for (uint32_t child : node->second.children)
+        {
+            if (node->second.type != 'S')
+            {
+                place(child, translation, level + 1);
+                continue;
+            }
+
+            if (child >= models.size()) continue;
+            Instance instance{child, {0, 0, 0}};
+
+            for (std::size_t k = 0; k < 3; ++k)
+                instance.min[k] = translation[k] - model_sizes[child][k] / 2;
+
+            instances.push_back(instance);
+        }
+    };
+
+    const int32_t origin[3] = {0, 0, 0};
+    place(0, origin, 0);
+
+    if (instances.empty())
+        throw std::runtime_error("No model instances in '" + path + "'");
+
+    /* The volume's min corner is moved to the origin. */
+    int32_t min[3] = {INT32_MAX, INT32_MAX, INT32_MAX};
+    int32_t max[3] = {INT32_MIN, INT32_MIN, INT32_MIN};
+
+    for (const Instance &instance : instances)
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            min[k] = std::min(min[k], instance.min[k]);
+            max[k] = std::max(max[k], instance.min[k]
+                                    + model_sizes[instance.model][k]);
+        }
+
+    for (Instance &instance : instances)
+        for (std::size_t k = 0; k < 3; ++k)
+            instance.min[k] -= min[k];
+
+    size[0] = (uint32_t)(max[0] - min[0]);
+    size[1] = (uint32_t)(max[2] - min[2]); // z is up
+    size[2] = (uint32_t)(max[1] - min[1]);
+}
+
+void Volume::read_vox(const std::function<void(uint32_t, uint32_t, uint32_t,
+                                                uint16_t)> &voxel)
+{
+    std::vector<uint8_t> block(VOX_BLOCK * 4);
+
+    for (const Instance &instance : instances)
+    {
+        const Model &model = models[instance.model];
+        file.clear();
+        file.seekg((std::streamoff)model.offset);
+
+        for (uint32_t done = 0; done < model.count; )
+        {
+            auto count = std::min((std::size_t)(model.count - done),
+                                  VOX_BLOCK);
+            if (!file.read((char *)block.data(), count * 4))
+                throw std::runtime_error("Failed to read '" + path + "'");
+
+            for (std::size_t t = 0; t < count; ++t)
+            {
+                const uint8_t *v = &block[t * 4];
+                if (v[3] == 0) continue; // not a palette entry
+
+                uint32_t x = instance.min[0] + v[0];
+                uint32_t y = instance.min[1] + v[1];
+                uint32_t z = instance.min[2] + v[2];
+
+                /* Malformed files may have voxels past their model's size. */
+                if ((x >= size[0]) || (y >= size[2]) || (z >= size[1]))
+                    throw std::runtime_error("Voxel outside of its model in '"
+                                           + path + "'");
+
+                voxel(x, z, size[2] - 1 - y, v[3]);
+            }
+
+            done += (uint32_t)count;
+        }
+    }
+}
+
+std::size_t Volume::stream_vox(SVOBuilder &builder, ThreadPool &pool,
+                               bool hide_interior)
+{
+    std::size_t added = 0;
+
+    if (!hide_interior)
+    {
+        read_vox([&](uint32_t x, uint32_t y, uint32_t z, uint16_t material)
+        {
+            builder.add(x, y, z, material);
+            ++added;
+        });
+
+        return added;
+    }
+
+    const std::size_t words = hollow::row_words(size[0]);
+    const std::size_t slab = words * size[1];
+    std::vector<uint64_t> solid(slab * size[2]), exposed(solid.size());
+
+    auto word = [&](uint32_t x, uint32_t y, uint32_t z)
+    {
+        return z * slab + y * words + x / 64;
+    };
+
+    read_vox([&](uint32_t x, uint32_t y, uint32_t z, uint16_t)
+    {
+        solid[word(x, y, z)] |= 1ull << (x % 64);
+    });
+
+    for (uint32_t z = 0; z < size[2]; ++z)
+        hollow::exposed((z > 0) ? &solid[(z - 1) * slab] : nullptr,
+                        &solid[z * slab],
+                        (z + 1 < size[2]) ? &solid[(z + 1) * slab] : nullptr,
+                        &exposed[z * slab], size[0], size[1], pool);
+
+    read_vox([&](uint32_t x, uint32_t y, uint32_t z, uint16_t material)
+    {
+        if (!(exposed[word(x, y, z)] & (1ull << (x % 64))))
+            material = SVOBuilder::HIDDEN;
+
+        builder.add(x, y, z, material);
+        ++added;
+    });
+
+    return added;
+}
@@ -0,0 +1,202 @@
+#include "geometry/voxelizer.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <mutex>
+
+/* Voxels are grown by this much in the overlap test, so that triangles lying *
+ * exactly on the face (or edge) of a voxel are found to overlap it as well.  */
+static const float EPSILON = 1e-4f;
+
+/* Finds the range of voxels covered by a triangle's bounding box within the *
+ * world, returning false if the box is entirely outside of the world.      */
+static bool voxel_bounds(const math::float3 (&v)[3], const uint32_t extent[3],
+                         uint32_t lo[3], uint32_t hi[3])
+{
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+        float min = std::min(std::min(v[0][k], v[1][k]), v[2][k]) - EPSILON;
+        float max = std::max(std::max(v[0][k], v[1][k]), v[2][k]) + EPSILON;
+        if ((max < 0) || (min >= (float)extent[k])) return false;
+
+        lo[k] = (uint32_t)std::max(min, 0.0f);
+        hi[k] = (uint32_t)std::min(max, (float)(extent[k] - 1));
+    }
+
+    return true;
+}
+
+/* Tests whether a triangle overlaps a voxel, given the voxel's center. */
+static bool overlaps(const math::float3 (&v)[3], const math::float3 (&e)[3],
+                     const math::float3 &normal, const math::float3 &center)
+{
+    const float h = 0.5f + EPSILON;
+    const math::float3 a[3] = {v[0] - center, v[1] - center, v[2] - center};
+
+    float d = math::dot(normal, a[0]);
+    if (std::abs(d) > h * (std::abs(normal.x) + std::abs(normal.y)
+                                              + std::abs(normal.z)))
+        return false;
+
+    for (std::size_t t = 0; t < 3; ++t)
+    {
+        /* The cross products of the box's axes with this edge. */
+        const math::float3 axes[3] =
+        {
+            math::float3(0, -e[t].z, e[t].y),
+            math::float3(e[t].z, 0, -e[t].x),
+            math::float3(-e[t].y, e[t].x, 0),
+        };
+
+        for (const math::float3 &axis : axes)
+        {
+            float p0 = math::dot(axis, a[0]);
+            float p1 = math::dot(axis, a[1]);
+            float p2 = math::dot(axis, a[2]);
+            float r = h * (std::abs(axis.x) + std::abs(axis.y)
+                                            + std::abs(axis.z));
+
+            if ((std::min(std::min(p0, p1), p2) > r)
+             || (std::max(std::max(p0, p1), p2) < -r))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t voxelizer::run(const Mesh &mesh, const math::float3 &origin,
+                           float scale, SVOBuilder &builder, ThreadPool &pool)
+{
+    const auto &triangles = mesh.triangles();
+    uint32_t n = builder.resolution();
+    const uint32_t extent[3] = {builder.grid_width() * n,
+                                builder.grid_height() * n,
+                                builder.grid_depth() * n};
+
+    std::vector<math::float3> vertices(mesh.vertices().size());
+    const std::size_t BLOCK = 1 << 16; // vertices per iteration
+
+    pool.run((vertices.size() + BLOCK - 1) / BLOCK, [&](std::size_t b)
+    {
+        std::size_t end = std::min((b + 1) * BLOCK, vertices.size());
+
+        for (std::size_t t = b * BLOCK; t < end; ++t)
+            vertices[t] = (mesh.vertices()[t] - origin) * scale;
+    });
+
+    uint32_t longest = std::max(std::max(extent[0], extent[1]), extent[2]);
+    uint32_t tile = std::max(TILE_SIZE, (longest + MAX_TILES - 1) / MAX_TILES);
+    const uint32_t tiles[3] = {(extent[0] + tile - 1) / tile,
+                               (extent[1] + tile - 1) / tile,
+                               (extent[2] + tile - 1) / tile};
+
+    /* Bins the triangles by tile, by counting them and then placing them. */
+    std::vector<uint32_t> start(tiles[0] * tiles[1] * tiles[2] + 1, 0);
+    std::vector<uint32_t> binned;
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            std::partial_sum(start.begin(), start.end(), start.begin());
+            binned.resize(start.back());
+        }
+
+        for (std::size_t t = 0; t < triangles.size(); ++t)
+        {
+            const uint32_t *index = triangles[t].vertex;
+            const math::float3 v[3] = {vertices[index[0]], vertices[index[1]],
+                                       vertices[index[2]]};
+            uint32_t lo[3], hi[3];
+            if (!voxel_bounds(v, extent, lo, hi)) continue;
+
+            for (uint32_t z = lo[2] / tile; z <= hi[2] / tile; ++z)
+                for (uint32_t y = lo[1] / tile; y <= hi[1] / tile; ++y)
+                    for (uint32_t x = lo[0] / tile; x <= hi[0] / tile; ++x)
+                    {
+                        uint32_t bin = (z * tiles[1] + y) * tiles[0] + x;
+
+                        if (pass == 0) ++start[bin + 1];
+                        else binned[start[bin]++] = (uint32_t)t;
+                    }
+        }
+    }
+
+    /* Placing the triangles moved each tile's start to the next tile's. */
+    std::rotate(start.rbegin(), start.rbegin() + 1, start.rend());
+    start[0] = 0;
+
+    std::vector<uint32_t> busy;
+    for (uint32_t bin = 0; bin + 1 < start.size(); ++bin)
+        if (start[bin] != start[bin + 1]) busy.push_back(bin);
+
+    std::mutex mutex;
+    std::size_t added = 0;
+
+    pool.run(busy.size(), [&](std::size_t b)
+    {
+        uint32_t bin = busy[b];
+        const uint32_t corner[3] = {bin % tiles[0] * tile,
+                                    bin / tiles[0] % tiles[1] * tile,
+                                    bin / tiles[0] / tiles[1] * tile};
+
+        /* Each voxel is the position within the tile, then the material. */
+        std::vector<uint64_t> voxels;
+
+        for (uint32_t s = start[bin]; s < start[bin + 1]; ++s)
+        {
+            const Mesh::Triangle &triangle = triangles[binned[s]];
+            const math::float3 v[3] = {vertices[triangle.vertex[0]],
+                                       vertices[triangle.vertex[1]],
+                                       vertices[triangle.vertex[2]]};
+            const math::float3 e[3] = {v[1] - v[0], v[2] - v[1],
+                                       v[0] - v[2]};
+            const math::float3 normal = math::cross(e[0], e[1]);
+
+            uint32_t lo[3], hi[3];
+            voxel_bounds(v, extent, lo, hi);
+
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                lo[k] = std::max(lo[k], corner[k]);
+                hi[k] = std::min(hi[k], corner[k] + tile - 1);
+            }
+
+            for (uint32_t x = lo[0]; x <= hi[0]; ++x)
+                for (uint32_t y = lo[1]; y <= hi[1]; ++y)
+                    for (uint32_t z = lo[2]; z <= hi[2]; ++z)
+                    {
+                        math::float3 center(x + 0.5f, y + 0.5f, z + 0.5f);
+                        if (!overlaps(v, e, normal, center)) continue;
+
+                        uint64_t position = ((uint64_t)(x - corner[0]) * tile
+                                          + (y - corner[1])) * tile
+                                          + (z - corner[2]);
+                        voxels.push_back((position << 16) | triangle.material);
+                    }
+        }
+
+        /* Keeps the lowest material of the triangles overlapping a voxel. */
+        std::sort(voxels.begin(), voxels.end());
+        auto last = std::unique(voxels.begin(), voxels.end(),
+                                [](uint64_t a, uint64_t b)
+                                { return (a >> 16) == (b >> 16); });
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto voxel = voxels.begin(); voxel != last; ++voxel)
+        {
+            uint64_t position = *voxel >> 16;
+            builder.add(corner[0] + (uint32_t)(position / tile / tile),
+                        corner[1] + (uint32_t)(position / tile % tile),
+                        corner[2] + (uint32_t)(position % tile),
+                        (uint16_t)(*voxel & 0xFFFF));
+        }
+
+        added += last - voxels.begin();
+    });
+
+    return added;
+}
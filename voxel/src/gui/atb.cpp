@@ -8,16 +8,21 @@
 #include <vector>
 #include <map>
 
-#include "modules/subsamplers.hpp"
 #include "modules/projections.hpp"
 #include "modules/integrators.hpp"
+#include "modules/generators.hpp"
+#include "render/samples.hpp"
+#include "render/post.hpp"
 
 using std::unique_ptr;
 
-static TwType subsamplers_t, projections_t, integrators_t;
+static TwType subsamplers_t, projections_t, integrators_t, generators_t;
+static TwType tonemappers_t;
 TwType atb::subsamplers(void) { return subsamplers_t; }
 TwType atb::projections(void) { return projections_t; }
 TwType atb::integrators(void) { return integrators_t; }
+TwType atb::generators(void) { return generators_t; }
+TwType atb::tonemappers(void) { return tonemappers_t; }
 
 static void TW_CALL set_cb(const void *value, void *id);
 static void TW_CALL get_cb(      void *value, void *id);
@@ -38,9 +43,11 @@ struct Variable
             float v_color3f[3];
             float v_color4f[4];
             float v_dir3f[3];
-            subsamplers::modules v_subsampler;
+            SampleTable::Pattern v_subsampler;
             projections::modules v_projection;
             integrators::modules v_integrator;
+            generators::modules v_generator;
+            PostProcess::Operator v_tonemapper;
         } data;
 
         std::size_t get_type_size(TwType type)
@@ -55,6 +62,8 @@ struct Variable
             if (type == atb::subsamplers()) return sizeof(data.v_subsampler);
             if (type == atb::projections()) return sizeof(data.v_projection);
             if (type == atb::integrators()) return sizeof(data.v_integrator);
+            if (type == atb::generators()) return sizeof(data.v_generator);
+            if (type == atb::tonemappers()) return sizeof(data.v_tonemapper);
             throw new std::logic_error("Unknown TweakBar variable type");
         }
 
@@ -125,12 +134,11 @@ static void define_types(void)
 {
     subsamplers_t = TwDefineEnum("Subsampler", (const TwEnumVal[])
     {
-        {subsamplers::modules::NONE,        "None"},
-        {subsamplers::modules::AAx2,        "2xAA"},
-        {subsamplers::modules::AAx4,        "4xAA"},
-        {subsamplers::modules::AAx8,        "8xAA"},
-        {subsamplers::modules::AAx16,       "16xAA"},
-    },   subsamplers::modules::COUNT_);
+        {SampleTable::Pattern::NONE,        "None"},
+        {SampleTable::Pattern::HALTON,      "Halton"},
+        {SampleTable::Pattern::SOBOL,       "Sobol"},
+        {SampleTable::Pattern::PMJ,         "PMJ"},
+    },   SampleTable::Pattern::COUNT_);
 
     projections_t = TwDefineEnum("Projection", (const TwEnumVal[])
     {
@@ -143,7 +151,24 @@ static void define_types(void)
         {integrators::modules::DEPTH,       "Depth"},
         {integrators::modules::NORMAL,      "Normal Map"},
         {integrators::modules::AO,          "Ambient Occlusion"},
+        {integrators::modules::AO_BOUNDED,  "Bounded AO"},
+        {integrators::modules::PATH,        "Path Tracer"},
     },   integrators::modules::COUNT_);
+
+    generators_t = TwDefineEnum("Generator", (const TwEnumVal[])
+    {
+        {generators::modules::THREEFISH,    "Threefish"},
+        {generators::modules::PCG32,        "PCG32"},
+        {generators::modules::PHILOX,       "Philox"},
+        {generators::modules::HASH,         "Hash"},
+    },   generators::modules::COUNT_);
+
+    tonemappers_t = TwDefineEnum("Tonemapper", (const TwEnumVal[])
+    {
+        {PostProcess::Operator::LINEAR,     "Linear"},
+        {PostProcess::Operator::REINHARD,   "Reinhard"},
+        {PostProcess::Operator::FILMIC,     "Filmic"},
+    },   PostProcess::Operator::COUNT_);
 }
 
 void atb::initialize(const char *bar_title)
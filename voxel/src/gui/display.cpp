@@ -7,15 +7,21 @@
 #include <SFML/Window.hpp>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cmath>
 
 #include "modules/integrators.hpp"
-#include "modules/subsamplers.hpp"
+#include "modules/generators.hpp"
 #include "modules/projections.hpp"
 
+#include "render/image_io.hpp"
 #include "render/engine.hpp"
+#include "setup/profiler.hpp"
+#include "setup/tracer.hpp"
 #include "setup/interop.hpp"
+#include "setup/scheduler.hpp"
 
 using std::unique_ptr;
 
@@ -23,31 +29,143 @@ static std::string window_title;
 static const double SPP_REFRESH_RATE = 1.5;
 static const std::size_t initial_w = 800, initial_x = 200;
 static const std::size_t initial_h = 600, initial_y = 200;
-static const auto default_subsampler = subsamplers::modules::AAx4;
+static const auto default_subsampler = SampleTable::Pattern::HALTON;
+static const std::size_t default_subsamples = 4;
 static const auto default_projection = projections::modules::PERSPECTIVE;
 static const auto default_integrator = integrators::modules::DEPTH;
+static const auto default_generator = generators::modules::THREEFISH;
+static const float min_scale = 0.25f; // for dynamic resolution
+static const std::size_t max_samples = 256; // per frame, when automatic
+
+/* These are the commands whose rolling average duration is displayed when the *
+ * profiler is enabled (the first field is the tweak bar variable's ID).      */
+static const struct { const char *id, *label, *command; } statistics[] =
+{
+    {"stat_render",  "Render (ms)",     "render"      },
+    {"stat_denoise", "Denoise (ms)",    "denoise"     },
+    {"stat_copy",    "Copy (ms)",       "interop_copy"},
+    {"stat_write",   "Uploads (ms)",    "write"       },
+    {"stat_acquire", "CL Acquire (ms)", "acquire"     },
+    {"stat_release", "GL Release (ms)", "release"     },
+};
+
+static void setup_statistics(void)
+{
+    for (auto &stat : statistics)
+    {
+        atb::add_var(stat.id, stat.label, TW_TYPE_FLOAT,
+                     "readonly=true precision=3 group='Statistics'");
+        atb::set_var(stat.id, 0.0f);
+    }
+}
+
+static void update_statistics(void)
+{
+    profiler::collect(); // only picks up completed commands
+
+    for (auto &stat : statistics)
+        atb::set_var(stat.id, (float)profiler::average(stat.command));
+}
+
+/* Shows the geometry streaming statistics, over the time elapsed since the *
+ * previous call (given the cumulative statistics at that time).            */
+static void update_streaming(const World &world, double elapsed,
+                             PagedGeometry::Stats &last)
+{
+    const PagedGeometry::Stats &stats = world.pages().stats();
+    double hits = (double)(stats.hits - last.hits);
+    double misses = (double)(stats.misses - last.misses);
+    double bytes = (double)(stats.uploaded - last.uploaded);
+    double read = (double)(stats.read - last.read);
+
+    float hit_rate = (hits + misses > 0) ? 100 * hits / (hits + misses) : 100;
+    atb::set_var("pages", (uint32_t)world.pages().resident());
+    atb::set_var("hit_rate", hit_rate);
+    atb::set_var("uploads", (float)(bytes / elapsed / (1 << 20)));
+    atb::set_var("reads", (float)(read / elapsed / (1 << 20)));
+    last = stats;
+}
 
 static void setup_tweak_bar(void)
 {
     atb::add_var("subsampler", "Subsampler", atb::subsamplers(),
                  "group='Modules'");
+    atb::add_var("subsamples", "Subsamples", TW_TYPE_UINT32,
+                 "min=1 max=4096 group='Modules'");
     atb::add_var("projection", "Projection", atb::projections(),
                  "group='Modules'");
     atb::add_var("integrator", "Integrator", atb::integrators(),
                  "group='Modules'");
+    atb::add_var("generator", "Generator", atb::generators(),
+                 "group='Modules'");
+    atb::add_var("ao_rays", "AO Rays", TW_TYPE_UINT32,
+                 "min=1 max=64 group='Modules'");
+    atb::add_var("ao_range", "AO Range", TW_TYPE_FLOAT,
+                 "min=0.01 max=2 step=0.01 group='Modules'");
+    atb::add_var("denoise", "Denoiser Passes", TW_TYPE_UINT32,
+                 "min=0 max=5 group='Post-processing'");
+    atb::add_var("exposure", "Exposure (EV)", TW_TYPE_FLOAT,
+                 "min=-8 max=8 step=0.1 group='Post-processing'");
+    atb::add_var("tonemapper", "Tonemapper", atb::tonemappers(),
+                 "group='Post-processing'");
+    atb::add_var("srgb", "sRGB Encoding", TW_TYPE_BOOLCPP,
+                 "group='Post-processing'");
+    atb::add_var("dither", "Dithering", TW_TYPE_BOOLCPP,
+                 "group='Post-processing'");
+    atb::add_var("aovs", "AOV Buffers (F12)", TW_TYPE_BOOLCPP,
+                 "group='Miscellaneous'");
+    atb::add_var("dyn_res", "Dynamic Resolution", TW_TYPE_BOOLCPP,
+                 "group='Miscellaneous'");
+    atb::add_var("latency", "Target Latency (ms)", TW_TYPE_FLOAT,
+                 "min=5 max=200 step=1 group='Miscellaneous'");
+    atb::add_var("auto_spp", "Automatic Samples", TW_TYPE_BOOLCPP,
+                 "group='Miscellaneous'");
+    atb::add_var("budget", "Frame Budget (ms)", TW_TYPE_FLOAT,
+                 "min=1 max=100 step=1 group='Miscellaneous'");
+    atb::add_var("idle_budget", "Idle Budget (ms)", TW_TYPE_FLOAT,
+                 "min=1 max=1000 step=10 group='Miscellaneous'");
     atb::add_var("work_ratio", "Samples/Frame", TW_TYPE_UINT32,
                  "min=1 max=16 group='Miscellaneous'");
+    atb::add_var("pages", "Resident Pages", TW_TYPE_UINT32,
+                 "readonly=true group='Streaming'");
+    atb::add_var("hit_rate", "Page Hit Rate (%)", TW_TYPE_FLOAT,
+                 "readonly=true precision=1 group='Streaming'");
+    atb::add_var("uploads", "Uploads (MiB/s)", TW_TYPE_FLOAT,
+                 "readonly=true precision=2 group='Streaming'");
+    atb::add_var("reads", "Disk Reads (MiB/s)", TW_TYPE_FLOAT,
+                 "readonly=true precision=2 group='Streaming'");
     atb::add_var("rot_speed", "Rotation Speed", TW_TYPE_FLOAT,
                  "min=0.5 max=10 step=0.1 group='Miscellaneous'");
     atb::add_var("move_speed", "Movement Speed", TW_TYPE_FLOAT,
                  "min=0.1 max=10 step=0.1 group='Miscellaneous'");
 
     atb::set_var("subsampler", default_subsampler);
+    atb::set_var("subsamples", (uint32_t)default_subsamples);
     atb::set_var("projection", default_projection);
     atb::set_var("integrator", default_integrator);
+    atb::set_var("generator", default_generator);
+    atb::set_var("ao_rays", 4);
+    atb::set_var("ao_range", 0.25f);
+    atb::set_var("denoise", 4);
+    atb::set_var("exposure", 0.0f);
+    atb::set_var("tonemapper", PostProcess::Operator::FILMIC);
+    atb::set_var("srgb", true);
+    atb::set_var("dither", true);
+    atb::set_var("aovs", false);
+    atb::set_var("dyn_res", true);
+    atb::set_var("latency", 33.0f);
+    atb::set_var("auto_spp", true);
+    atb::set_var("budget", 16.0f);
+    atb::set_var("idle_budget", 100.0f);
     atb::set_var("work_ratio", 1);
     atb::set_var("rot_speed", 5.0f);
     atb::set_var("move_speed", 3.0f);
+    atb::set_var("pages", (uint32_t)0);
+    atb::set_var("hit_rate", 100.0f);
+    atb::set_var("uploads", 0.0f);
+    atb::set_var("reads", 0.0f);
+
+    if (profiler::enabled()) setup_statistics();
 }
 
 unique_ptr<sf::Window> display::initialize(const std::string &name)
@@ -79,11 +197,11 @@ static void update_title(unique_ptr<sf::Window> &window,
 
 static void check_modules(Engine &engine)
 {
-    if (atb::has_changed("subsampler"))
+    if (atb::has_changed("subsampler") || atb::has_changed("subsamples"))
     {
-        auto module_id = atb::get_var<subsamplers::modules>("subsampler");
-        const cl::Program &module = subsamplers::get(module_id);
-        engine.set_module(Engine::Module::SUBSAMPLER, module);
+        auto pattern = atb::get_var<SampleTable::Pattern>("subsampler");
+        auto count = atb::get_var<uint32_t>("subsamples");
+        engine.set_subsampler(pattern, count);
     }
 
     if (atb::has_changed("projection"))
@@ -93,27 +211,129 @@ static void check_modules(Engine &engine)
         engine.set_module(Engine::Module::PROJECTION, module);
     }
 
-    if (atb::has_changed("integrator"))
+    /* The AO parameters are compiled into the bounded AO integrator, which *
+     * therefore needs to be rebuilt (only) if it is in use when they change. */
+    bool module_changed = atb::has_changed("integrator");
+    bool params_changed = atb::has_changed("ao_rays")
+                       || atb::has_changed("ao_range");
+
+    if (module_changed || params_changed)
     {
         auto module_id = atb::get_var<integrators::modules>("integrator");
-        const cl::Program &module = integrators::get(module_id);
-        engine.set_module(Engine::Module::INTEGRATOR, module);
+        auto rays = atb::get_var<uint32_t>("ao_rays");
+        auto range = atb::get_var<float>("ao_range");
+
+        if (module_id == integrators::modules::AO_BOUNDED)
+        {
+            auto module = integrators::bounded_ambient_occlusion(rays, range);
+            engine.set_module(Engine::Module::INTEGRATOR, module);
+        }
+        else if (module_changed)
+        {
+            const cl::Program &module = integrators::get(module_id);
+            engine.set_module(Engine::Module::INTEGRATOR, module);
+        }
     }
+
+    if (atb::has_changed("generator"))
+    {
+        auto module_id = atb::get_var<generators::modules>("generator");
+        const cl::Program &module = generators::get(module_id);
+        engine.set_module(Engine::Module::GENERATOR, module);
+    }
+}
+
+static void check_post_process(Engine &engine)
+{
+    PostProcess &post = engine.post_process();
+
+    if (atb::has_changed("aovs"))
+        engine.set_aovs(atb::get_var<bool>("aovs"));
+
+    if (atb::has_changed("denoise"))
+        engine.denoiser().set_passes(atb::get_var<uint32_t>("denoise"));
+
+    if (atb::has_changed("exposure"))
+        post.set_exposure(atb::get_var<float>("exposure"));
+
+    if (atb::has_changed("tonemapper"))
+        post.set_operator(atb::get_var<PostProcess::Operator>("tonemapper"));
+
+    if (atb::has_changed("srgb"))
+        post.set_srgb(atb::get_var<bool>("srgb"));
+
+    if (atb::has_changed("dither"))
+        post.set_dither(atb::get_var<bool>("dither"));
 }
 
-static void process_input(Engine &engine, World &world)
+/* Saves the depth, normal and material AOV's of the last sample into files in *
+ * the working directory (the AOV buffers must have been enabled beforehand). */
+static void save_aovs(Engine &engine)
 {
+    if (!atb::get_var<bool>("aovs"))
+    {
+        print_warning("AOV buffers must be enabled before saving AOV's");
+        return;
+    }
+
+    AOVs aovs = engine.read_aovs();
+    std::size_t w = aovs.width, h = aovs.height;
+
+    if (image_io::write_pfm("aov_depth.pfm", w, h, 1, aovs.depth)
+     && image_io::write_pfm("aov_normal.pfm", w, h, 3, aovs.normal)
+     && image_io::write_pgm("aov_material.pgm", w, h, aovs.material))
+        print_info("Saved AOV's to 'aov_{depth,normal}.pfm, aov_material.pgm'");
+    else
+        print_error("Failed to save AOV's");
+}
+
+/* Returns whether the observer was moved (which invalidates the frame). */
+static bool process_input(Engine &engine, World &world)
+{
+    bool moved = false;
+
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W))
     {
         world.forward(+atb::get_var<float>("move_speed") * 1e-2f);
         engine.clear_frame();
+        moved = true;
     }
 
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S))
     {
         world.forward(-atb::get_var<float>("move_speed") * 1e-2f);
         engine.clear_frame();
+        moved = true;
     }
+
+    return moved;
+}
+
+/* While the observer moves, the frame is rendered at a resolution scale which *
+ * is adjusted every frame so that the frame time approaches the target, which *
+ * goes as the square of the scale (damped, so that it does not oscillate).   */
+static float rescale(float scale, double frame_time)
+{
+    double target = atb::get_var<float>("latency") * 1e-3;
+    float ratio = (float)std::sqrt(target / std::max(frame_time, 1e-4));
+    ratio = std::min(std::max(ratio, 0.8f), 1.25f);
+    return std::min(std::max(scale * ratio, min_scale), 1.0f);
+}
+
+/* Picks how many samples to render in a frame: either the manual setting, or *
+ * as many as fit in the time budget (a shorter one while the observer moves) *
+ * given the running average time per sample (zero if not yet measured).     */
+static size_t samples_per_frame(bool moving, double sample_time)
+{
+    if (!atb::get_var<bool>("auto_spp"))
+        return atb::get_var<uint32_t>("work_ratio");
+
+    if (sample_time <= 0) return 1;
+
+    const char *id = moving ? "budget" : "idle_budget";
+    double budget = atb::get_var<float>(id) * 1e-3;
+    auto samples = (size_t)(budget / sample_time);
+    return std::min(std::max(samples, (size_t)1), max_samples);
 }
 
 void display::run(unique_ptr<sf::Window> &window, World &world)
@@ -123,22 +343,34 @@ void display::run(unique_ptr<sf::Window> &window, World &world)
     cl::ImageGL image = interop::get_image(initial_w, initial_h);
 
     print_info("Starting rendering engine and event loop");
-    Engine engine(subsamplers::get(default_subsampler),
-                  projections::get(default_projection),
+    Engine engine(projections::get(default_projection),
                   integrators::get(default_integrator),
+                  generators::get(default_generator),
                   image);
     engine.attach(world);
+    engine.set_subsampler(default_subsampler, default_subsamples);
+    engine.denoiser().set_passes(atb::get_var<uint32_t>("denoise"));
 
     sf::Vector2u cursor_pos;
     bool mouse_down = false;
     size_t sample_count = 0;
-    sf::Clock clock;
+    sf::Clock clock, frame_clock;
+    double sample_time = 0;
+    float scale = 1;
+    PagedGeometry::Stats streamed = world.pages().stats();
 
     while (window->isOpen())
     {
+        tracer::frame(); // previous frame done
+        tracer::Zone frame_zone("frame");
+        double frame_time = frame_clock.restart().asSeconds();
+        bool moved = false;
+
         sf::Event event; // event loop
         while (window->pollEvent(event))
         {
+            tracer::Zone event_zone("event");
+
             /* Was this meant for ATB? */
             if (atb::handle_event(event))
                 mouse_down = false;
@@ -174,6 +406,7 @@ void display::run(unique_ptr<sf::Window> &window, World &world)
                         world.turn_h(-dx * speed);
                         world.turn_v(+dy * speed);
                         engine.clear_frame();
+                        moved = true;
                     }
                 }
             }
@@ -191,35 +424,85 @@ void display::run(unique_ptr<sf::Window> &window, World &world)
             else if ((event.type == sf::Event::KeyPressed)
                   && (event.key.code == sf::Keyboard::Escape))
                 return;
+            /* Save the AOV's (of the last sample rendered). */
+            else if ((event.type == sf::Event::KeyPressed)
+                  && (event.key.code == sf::Keyboard::F12))
+                save_aovs(engine);
 
             /* This is just for better presentation. */
             window->setMouseCursorVisible(!mouse_down);
         }
 
-        process_input(engine, world);
-        check_modules(engine);
+        {
+            tracer::Zone zone("input");
+            moved |= process_input(engine, world);
+            check_modules(engine);
+            check_post_process(engine);
+
+            /* Full resolution (and accumulation) resumes once it stops. */
+            bool dynamic = moved && atb::get_var<bool>("dyn_res");
+            float next = dynamic ? rescale(scale, frame_time) : 1.0f;
+            if (next != scale)
+            {
+                /* The time per sample goes as the number of pixels, so the *
+                 * average carries over (discarding it would leave a single  *
+                 * sample per frame until it is measured again, and so the   *
+                 * frame time, and then the scale, would oscillate).         */
+                sample_time *= (next / scale) * (next / scale);
+                engine.set_scale(scale = next);
+            }
+        }
 
         if (clock.getElapsedTime().asSeconds() >= SPP_REFRESH_RATE)
         {
             double elapsed = clock.getElapsedTime().asSeconds();
             double samples = (double)sample_count / elapsed;
             update_title(window, window_title, samples);
+            update_streaming(world, elapsed, streamed);
             sample_count = 0;
             clock.restart();
         }
 
+        if (profiler::enabled()) update_statistics();
+
         interop::synchronize_cl(image); /* NOW RENDERING | OpenCL ----------- */
 
-        size_t samples = atb::get_var<uint32_t>("work_ratio");
-        for (size_t t = 0; t < samples; ++t) engine.sample();
-        sample_count += samples;
-        engine.draw();
+        {
+            tracer::Zone zone("sample");
+            size_t samples = samples_per_frame(moved, sample_time);
+
+            /* Kernels only wait for the work before them once run (see      *
+             * scheduler::run), so the queue is drained before and after the *
+             * samples, for the time to cover all of them and none of the    *
+             * draws (including the last frame's, which may still be going). */
+            scheduler::flush();
+            sf::Clock sample_clock;
+            for (size_t t = 0; t < samples; ++t) engine.sample();
+            scheduler::flush();
+
+            double elapsed = sample_clock.getElapsedTime().asSeconds();
+            double measured = elapsed / samples;
+            sample_time = (sample_time > 0) ? 0.8 * sample_time
+                                            + 0.2 * measured : measured;
+
+            sample_count += samples;
+            engine.draw();
+        }
+
+        {
+            tracer::Zone zone("stream");
+            float aspect = (float)window->getSize().x / window->getSize().y;
+            if (world.update(aspect)) engine.clear_frame();
+        }
 
         interop::synchronize_gl(image); /* NOW DISPLAYING | OpenGL ---------- */
 
-        interop::draw_image(image);
-        atb::draw_tweak_bar();
-        window->display();
+        {
+            tracer::Zone zone("display");
+            interop::draw_image(image);
+            atb::draw_tweak_bar();
+            window->display();
+        }
     }
 }
 
@@ -1,5 +1,6 @@
 #include <CL/cl.hpp>
 #include <stdexcept>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -8,18 +9,201 @@
     #error "OpenCL 1.2 is required to build this software!"
 #endif
 
+#include "setup/profiler.hpp"
+#include "setup/tracer.hpp"
+#include "setup/scheduler.hpp"
 #include "setup/devices.hpp"
 #include "setup/interop.hpp"
+#include "setup/prng_bench.hpp"
+#include "render/regression.hpp"
+#include "render/tiled.hpp"
+#include "geometry/importer.hpp"
 #include "world/world.hpp"
 #include "gui/display.hpp"
 #include "gui/log.hpp"
 
+static std::size_t page_budget = World::DEFAULT_PAGE_BUDGET;
+static std::string world_path; // the procedural test world if empty
+
+/* Parses the optional arguments following the device name, and returns false *
+ * if any of them is not recognized (in which case the usage is printed out). */
+static bool parse_options(int argc, char *argv[])
+{
+    for (int t = 3; t < argc; ++t)
+    {
+        if (!strcmp(argv[t], "--profile"))
+            profiler::enable();
+        else if (!strcmp(argv[t], "--trace") && (t + 2 < argc))
+        {
+            int frames = atoi(argv[++t]);
+            if (frames <= 0)
+            {
+                print_error("Number of frames to trace must be positive");
+                return false;
+            }
+
+            profiler::enable(); // device timings are needed
+            tracer::enable(argv[++t], (std::size_t)frames);
+        }
+        else if (!strcmp(argv[t], "--page-budget") && (t + 1 < argc))
+        {
+            int megabytes = atoi(argv[++t]);
+            if (megabytes <= 0)
+            {
+                print_error("Page budget (in MiB) must be positive");
+                return false;
+            }
+
+            page_budget = (std::size_t)megabytes << 20;
+        }
+        else if (!strcmp(argv[t], "--world") && (t + 1 < argc))
+            world_path = argv[++t];
+        else
+        {
+            print_error("Unknown option '" + std::string(argv[t]) + "'");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Runs the regression suite headlessly (the device does not need interop), so *
+ * that it can also run on CPU-only OpenCL implementations.                   */
+static bool run_tests(int argc, char *argv[])
+{
+    bool bless = false;
+
+    if ((argc == 3) && !strcmp(argv[2], "--bless"))
+        bless = true;
+    else if (argc != 2)
+    {
+        print_error("Unknown option '" + std::string(argv[2]) + "'");
+        return false;
+    }
+
+    try
+    {
+        cl::Device device; // The device is selected by the user
+        if (!select_device(argv[0], device)) return false;
+
+        profiler::enable(); // For the kernel timings
+        scheduler::setup(device);
+        World world;
+
+        return regression::run(world, argv[1], bless);
+    }
+    catch (const cl::Error &e)
+    {
+        print_exception("OpenCL runtime error", e);
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        print_exception("A fatal error occurred", e);
+        return false;
+    }
+}
+
+/* Benchmarks the PRNG generators on a device (which needs no interop). */
+static bool benchmark_prng(const char *name)
+{
+    try
+    {
+        cl::Device device; // The device is selected by the user
+        if (!select_device(name, device)) return false;
+
+        scheduler::setup(device);
+        return prng_bench::run();
+    }
+    catch (const cl::Error &e)
+    {
+        print_exception("OpenCL runtime error", e);
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        print_exception("A fatal error occurred", e);
+        return false;
+    }
+}
+
+/* Renders a still image headlessly, tile by tile, which allows for images far *
+ * larger than would fit in device memory (or even in a single allocation).  */
+static bool render_still(const char *name, char *argv[])
+{
+    try
+    {
+        cl::Device device; // The device is selected by the user
+        if (!select_device(name, device)) return false;
+
+        int width = atoi(argv[0]), height = atoi(argv[1]);
+        int samples = atoi(argv[2]);
+
+        scheduler::setup(device);
+        World world;
+
+        return tiled::render(world, (std::size_t)std::max(width, 0),
+                             (std::size_t)std::max(height, 0),
+                             (std::size_t)std::max(samples, 0), argv[3]);
+    }
+    catch (const cl::Error &e)
+    {
+        print_exception("OpenCL runtime error", e);
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        print_exception("A fatal error occurred", e);
+        return false;
+    }
+}
+
+/* Imports a file into a world, which needs no device at all. */
+static bool import_world(int argc, char *argv[])
+{
+    bool hide_interior = true;
+
+    if ((argc == 4) && !strcmp(argv[3], "--keep-interior"))
+        hide_interior = false;
+    else if (argc != 3)
+    {
+        print_error("Unknown option '" + std::string(argv[3]) + "'");
+        return false;
+    }
+
+    try
+    {
+        int depth = atoi(argv[1]);
+        return importer::run(argv[0], (uint32_t)std::max(depth, 0), argv[2],
+                             hide_interior);
+    }
+    catch (const std::exception &e)
+    {
+        print_exception("A fatal error occurred", e);
+        return false;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     if ((argc == 2) && !strcmp(argv[1], "--list-devices"))
         return print_devices() ? EXIT_SUCCESS : EXIT_FAILURE;
 
-    if ((argc == 3) && !strcmp(argv[1], "--use-device"))
+    if ((argc >= 4) && (argc <= 5) && !strcmp(argv[1], "--run-tests"))
+        return run_tests(argc - 2, argv + 2) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if ((argc == 3) && !strcmp(argv[1], "--benchmark-prng"))
+        return benchmark_prng(argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if ((argc == 7) && !strcmp(argv[1], "--render"))
+        return render_still(argv[2], argv + 3) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if ((argc >= 5) && (argc <= 6) && !strcmp(argv[1], "--import"))
+        return import_world(argc - 2, argv + 2) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if ((argc >= 3) && !strcmp(argv[1], "--use-device")
+                    && parse_options(argc, argv))
     {
         try
         {
@@ -34,14 +218,17 @@ int main(int argc, char *argv[])
                 print_info("Selecting preferred interop interface");
                 interop::initialize(device, window->getSystemHandle());
                 print_info("Scheduler ready, interop is available");
-                print_info("Loading world from user-provided file");
-                print_warning("Not implemented yet");
-                World world;
+                if (world_path.empty())
+                    print_info("Generating procedural test world");
+                else print_info("Loading world from '" + world_path + "'");
+                World world(world_path, page_budget);
                 print_info("World ready");
 
                 try
                 {
                     display::run(window, world);
+                    tracer::finish(); // if exited early
+                    if (profiler::enabled()) profiler::summary();
                     display::finalize(window);
                 }
                 catch (const cl::Error &e)
@@ -71,8 +258,22 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
     }
 
-    printf("Usage:\n\n\t%s %s [name]", argv[0], "--use-device");
+    printf("Usage:\n\n\t%s %s [name] [options]", argv[0], "--use-device");
     printf(      "\n\t%s %s\n", argv[0], "--list-devices");
+    printf(        "\t%s %s [name] [dir] [--bless]\n", argv[0], "--run-tests");
+    printf(        "\t%s %s [name] [width] [height] [samples] [file]\n",
+           argv[0], "--render");
+    printf(        "\t%s %s [name]\n", argv[0], "--benchmark-prng");
+    printf(        "\t%s %s [source] [depth] [file] [--keep-interior]\n",
+           argv[0], "--import");
+    printf("\nOptions:\n\n\t%s\t\t\t%s\n", "--profile",
+           "Profile device commands (shows statistics)");
+    printf("\t%s\t%s\n", "--trace [frames] [file]",
+           "Write a Chrome trace of the first frames");
+    printf("\t%s\t%s\n", "--page-budget [MiB]",
+           "Device memory for geometry pages (default 32)");
+    printf("\t%s\t\t%s\n", "--world [file]",
+           "Open a world file (default test world)");
     printf("\nThis software requires OpenCL 1.2.\n");
     return EXIT_FAILURE; // Argument parsing error
 }
@@ -0,0 +1,40 @@
+#include "render/denoiser.hpp"
+
+#include "setup/scheduler.hpp"
+
+Denoiser::Denoiser(std::size_t width, std::size_t height)
+    : passes(0)
+{
+    resize(width, height);
+}
+
+void Denoiser::resize(std::size_t width, std::size_t height)
+{
+    count = width * height;
+
+    for (auto &buffer : buffers)
+        buffer = scheduler::alloc_buffer(count * 16, CL_MEM_READ_WRITE);
+}
+
+void Denoiser::set_passes(std::size_t passes)
+{
+    this->passes = passes;
+}
+
+const cl::Buffer &Denoiser::run(std::map<std::string, cl::Kernel> &kernels,
+                                const cl::Buffer &input)
+{
+    const cl::Buffer *src = &input;
+
+    for (std::size_t t = 0; t < passes; ++t)
+    {
+        cl::Buffer &dst = buffers[t % 2];
+        scheduler::set_arg(kernels["denoise"], "dns_src", *src);
+        scheduler::set_arg(kernels["denoise"], "dns_dst", dst);
+        scheduler::set_arg(kernels["denoise"], "dns_step", (cl_int)(1 << t));
+        scheduler::run(kernels["denoise"], cl::NDRange(count));
+        src = &dst;
+    }
+
+    return *src;
+}
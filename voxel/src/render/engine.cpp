@@ -1,36 +1,74 @@
 #include "setup/scheduler.hpp"
 #include "render/engine.hpp"
 
-Engine::Engine(const cl::Program &subsampler,
-               const cl::Program &projection,
+Engine::Engine(const cl::Program &projection,
                const cl::Program &integrator,
-               const cl::ImageGL &image)
-    : frame(image)
+               const cl::Program &generator,
+               const cl::Image &image)
+    : frame(image), filter(frame.width(), frame.height()),
+      samples(SampleTable::Pattern::NONE, 1)
 {
     core.push_back(scheduler::acquire("core/observer"));
     core.push_back(scheduler::acquire("core/geometry"));
+    core.push_back(scheduler::acquire("core/material"));
     core.push_back(scheduler::acquire("core/frame_io"));
     core.push_back(scheduler::acquire("core/math_lib"));
     core.push_back(scheduler::acquire("core/prng_lib"));
+    core.push_back(scheduler::acquire("core/sampler"));
+    core.push_back(scheduler::acquire("core/post_proc"));
+    core.push_back(scheduler::acquire("core/filter"));
+    core.push_back(scheduler::acquire("core/subsampler"));
     core.push_back(scheduler::acquire("main"));
-    modules[Module::SUBSAMPLER] = subsampler;
     modules[Module::PROJECTION] = projection;
     modules[Module::INTEGRATOR] = integrator;
+    modules[Module::GENERATOR] = generator;
 
     attach(frame);
+    attach(post);
+    attach(samples);
     link();
 }
 
+void Engine::set_subsampler(SampleTable::Pattern pattern, size_t count)
+{
+    samples.set(pattern, count);
+    samples.notify_cb(kernels);
+    clear_frame();
+}
+
 void Engine::set_module(Module type, const cl::Program &module)
 {
     modules[type] = module;
     link(); // new programs
 }
 
-void Engine::resize_frame(const cl::ImageGL &image)
+void Engine::resize_frame(const cl::Image &image)
 {
     frame.resize(image);
     frame.notify_cb(kernels);
+    filter.resize(frame.width(), frame.height());
+}
+
+void Engine::set_tile(size_t x, size_t y, size_t width, size_t height,
+                      size_t image_width, size_t image_height)
+{
+    frame.set_tile(x, y, width, height, image_width, image_height);
+}
+
+void Engine::set_scale(float scale)
+{
+    frame.set_scale(scale);
+}
+
+void Engine::set_aovs(bool enabled)
+{
+    frame.set_aovs(enabled);
+    frame.notify_cb(kernels);
+}
+
+AOVs Engine::read_aovs(void)
+{
+    return frame.read_aovs();
 }
 
 void Engine::clear_frame(void)
@@ -38,17 +76,34 @@ void Engine::clear_frame(void)
     frame.clear();
 }
 
+void Engine::reset_frame(void)
+{
+    frame.reset();
+}
+
 void Engine::sample(void)
 {
     frame.next();
-    scheduler::run(kernels["render"], cl::NDRange(frame.width() * frame.height()));
+    scheduler::run(kernels["render"], cl::NDRange(frame.pixels()));
 }
 
 void Engine::draw(void)
 {
+    const cl::Buffer &output = filter.run(kernels, frame.buffer());
+    scheduler::set_arg(kernels["interop_copy"], "frm_data", output);
     scheduler::run(kernels["interop_copy"], cl::NDRange(frame.width() * frame.height()));
 }
 
+PostProcess &Engine::post_process(void)
+{
+    return post;
+}
+
+Denoiser &Engine::denoiser(void)
+{
+    return filter;
+}
+
 void Engine::attach(const std::function
                     <void(std::map<std::string, cl::Kernel>&)>
                     &callback)
@@ -1,25 +1,68 @@
 #include "render/frame.hpp"
 
-Frame::Frame(const cl::ImageGL &image)
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+Frame::Frame(const cl::Image &image)
 {
+    info.aovs = false;
+    info.sample = 0;
     resize(image);
 }
 
-void Frame::resize(const cl::ImageGL &image)
+void Frame::resize(const cl::Image &image)
 {
     this->image = image;
     info.width = width();
     info.height = height();
+    info.offset_x = 0;
+    info.offset_y = 0;
+    info.image_width = width();
+    info.image_height = height();
+    info.output_width = width();
+    info.output_height = height();
     info.counter = 0;
 
     frame_buffer = scheduler::alloc_buffer(width() * height() * 16, CL_MEM_READ_WRITE);
+    feature_buffer = scheduler::alloc_buffer(width() * height() * 16, CL_MEM_READ_WRITE);
+    set_aovs(info.aovs);
     frame_info = scheduler::alloc_buffer(sizeof(FrameInfo), CL_MEM_READ_ONLY);
     clear();
 }
 
+void Frame::set_tile(size_t x, size_t y, size_t width, size_t height,
+                     size_t image_width, size_t image_height)
+{
+    if ((width > this->width()) || (height > this->height()))
+        throw std::logic_error("Tile does not fit in the frame");
+
+    info.width = width;
+    info.height = height;
+    info.offset_x = x;
+    info.offset_y = y;
+    info.image_width = image_width;
+    info.image_height = image_height;
+    info.output_width = width;
+    info.output_height = height;
+    clear();
+}
+
+void Frame::set_scale(float scale)
+{
+    info.width = std::max(1L, std::lround(width() * scale));
+    info.height = std::max(1L, std::lround(height() * scale));
+    info.offset_x = 0;
+    info.offset_y = 0;
+    info.image_width = info.width;
+    info.image_height = info.height;
+    clear();
+}
+
 void Frame::next(void)
 {
     ++info.counter;
+    info.sample = samples++;
 
     scheduler::write(frame_info, 0, sizeof(FrameInfo), &info);
 }
@@ -27,7 +70,11 @@ void Frame::notify_cb(std::map<std::string, cl::Kernel> &kernels)
 {
     scheduler::set_arg(kernels["render"], "frm_data", frame_buffer);
     scheduler::set_arg(kernels["render"], "frm_info", frame_info);
+    scheduler::set_arg(kernels["render"], "ftr_data", feature_buffer);
+    scheduler::set_arg(kernels["render"], "mat_data", material_buffer);
 
+    scheduler::set_arg(kernels["denoise"], "frm_info", frame_info);
+    scheduler::set_arg(kernels["denoise"], "ftr_data", feature_buffer);
 
     scheduler::set_arg(kernels["interop_copy"], "frm_data", frame_buffer);
     scheduler::set_arg(kernels["interop_copy"], "frm_info", frame_info);
@@ -36,9 +83,16 @@ void Frame::notify_cb(std::map<std::string, cl::Kernel> &kernels)
 
 void Frame::clear(void)
 {
+    samples = 0;
     scheduler::clear_buffer(frame_buffer, width() * height() * 16);
 }
 
+void Frame::reset(void)
+{
+    info.counter = 0;
+    clear();
+}
+
 size_t Frame::width()
 {
     return image.getImageInfo<CL_IMAGE_WIDTH>();
@@ -48,3 +102,49 @@ size_t Frame::height()
 {
     return image.getImageInfo<CL_IMAGE_HEIGHT>();
 }
+
+size_t Frame::pixels()
+{
+    return info.width * info.height;
+}
+
+const cl::Buffer &Frame::buffer()
+{
+    return frame_buffer;
+}
+
+void Frame::set_aovs(bool enabled)
+{
+    info.aovs = enabled;
+
+    std::size_t size = enabled ? width() * height() * 4 : 4;
+    material_buffer = scheduler::alloc_buffer(size, CL_MEM_WRITE_ONLY);
+}
+
+AOVs Frame::read_aovs()
+{
+    AOVs aovs;
+    aovs.width = width();
+    aovs.height = height();
+
+    std::size_t count = width() * height();
+    std::vector<cl_float4> features(count);
+    std::vector<cl_uint> materials(count);
+    scheduler::read(feature_buffer, 0, count * 16, features.data());
+    scheduler::read(material_buffer, 0, count * 4, materials.data(), true);
+
+    aovs.depth.resize(count);
+    aovs.normal.resize(count * 3);
+    aovs.material.resize(count);
+
+    for (std::size_t t = 0; t < count; ++t)
+    {
+        for (std::size_t c = 0; c < 3; ++c)
+            aovs.normal[t * 3 + c] = features[t].s[c];
+
+        aovs.depth[t] = features[t].s[3];
+        aovs.material[t] = (uint16_t)materials[t];
+    }
+
+    return aovs;
+}
@@ -0,0 +1,114 @@
+#include "render/image_io.hpp"
+
+bool image_io::write_ppm(const std::string &path, std::size_t width,
+                         std::size_t height, const std::vector<uint8_t> &rgb)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write((const char *)rgb.data(), width * height * 3);
+    return (bool)file;
+}
+
+image_io::PPMStream::PPMStream(const std::string &path, std::size_t width,
+                               std::size_t height)
+    : file(path, std::ios::binary), width(width), height(height), rows(0)
+{
+    file << "P6\n" << width << " " << height << "\n255\n";
+}
+
+bool image_io::PPMStream::write_rows(const std::vector<uint8_t> &rgb)
+{
+    std::size_t count = rgb.size() / (width * 3);
+    if ((rows + count > height) || (count * width * 3 != rgb.size()))
+        return false;
+
+    file.write((const char *)rgb.data(), rgb.size());
+    rows += count;
+    return (bool)file;
+}
+
+bool image_io::PPMStream::complete(void) const
+{
+    return file && (rows == height);
+}
+
+bool image_io::read_ppm(const std::string &path, std::size_t &width,
+                        std::size_t &height, std::vector<uint8_t> &rgb)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::string magic;
+    std::size_t maxval;
+    file >> magic >> width >> height >> maxval;
+    if (!file || (magic != "P6") || (maxval != 255)) return false;
+    file.get(); // single whitespace before the pixel data
+
+    rgb.resize(width * height * 3);
+    file.read((char *)rgb.data(), rgb.size());
+    return (bool)file;
+}
+
+bool image_io::write_pgm(const std::string &path, std::size_t width,
+                         std::size_t height, const std::vector<uint16_t> &gray)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file << "P5\n" << width << " " << height << "\n65535\n";
+
+    for (std::size_t t = 0; t < width * height; ++t) // big-endian
+    {
+        file.put((char)(gray[t] >> 8));
+        file.put((char)(gray[t] & 0xFF));
+    }
+
+    return (bool)file;
+}
+
+bool image_io::write_pfm(const std::string &path, std::size_t width,
+                         std::size_t height, std::size_t channels,
+                         const std::vector<float> &data)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    /* A negative scale means little-endian, and rows are stored bottom-up. */
+    file << (channels == 3 ? "PF" : "Pf") << "\n";
+    file << width << " " << height << "\n" << "-1.0\n";
+
+    const uint16_t probe = 1;
+    bool little_endian = *(const uint8_t *)&probe;
+
+    for (std::size_t y = height; y-- > 0; )
+        for (std::size_t t = 0; t < width * channels; ++t)
+        {
+            float value = data[y * width * channels + t];
+            auto bytes = (const char *)&value;
+
+            if (little_endian) file.write(bytes, sizeof(float));
+            else for (std::size_t b = sizeof(float); b-- > 0; )
+                file.put(bytes[b]);
+        }
+
+    return (bool)file;
+}
+
+std::vector<uint8_t> image_io::from_texture(std::size_t width,
+                                            std::size_t height,
+                                            const std::vector<uint8_t> &rgba)
+{
+    std::vector<uint8_t> rgb(width * height * 3);
+
+    for (std::size_t y = 0; y < height; ++y)
+        for (std::size_t x = 0; x < width; ++x)
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                std::size_t src = ((height - 1 - y) * width + x) * 4 + c;
+                rgb[(y * width + x) * 3 + c] = rgba[src];
+            }
+
+    return rgb;
+}
@@ -0,0 +1,50 @@
+#include "render/post.hpp"
+
+#include "setup/scheduler.hpp"
+
+#include <cmath>
+
+PostProcess::PostProcess()
+{
+    mem = scheduler::alloc_buffer(sizeof(buffer), CL_MEM_READ_ONLY);
+
+    buffer.exposure = 1;
+    buffer.op = FILMIC;
+    buffer.srgb = true;
+    buffer.dither = true;
+    update();
+}
+
+void PostProcess::update(void)
+{
+    scheduler::write(mem, 0, sizeof(buffer), &buffer);
+}
+
+void PostProcess::set_exposure(float stops)
+{
+    buffer.exposure = std::pow(2.0f, stops);
+    update();
+}
+
+void PostProcess::set_operator(Operator op)
+{
+    buffer.op = op;
+    update();
+}
+
+void PostProcess::set_srgb(bool enabled)
+{
+    buffer.srgb = enabled;
+    update();
+}
+
+void PostProcess::set_dither(bool enabled)
+{
+    buffer.dither = enabled;
+    update();
+}
+
+void PostProcess::notify_cb(std::map<std::string, cl::Kernel> &kernels)
+{
+    scheduler::set_arg(kernels["interop_copy"], "pst_info", mem);
+}
@@ -0,0 +1,188 @@
+#include "render/regression.hpp"
+#include "render/image_io.hpp"
+#include "render/engine.hpp"
+
+#include "modules/projections.hpp"
+#include "modules/integrators.hpp"
+#include "modules/generators.hpp"
+
+#include "setup/scheduler.hpp"
+#include "setup/profiler.hpp"
+#include "gui/log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
+static const std::size_t WIDTH = 160, HEIGHT = 120, SAMPLES = 16;
+static const auto SUBSAMPLER = SampleTable::Pattern::HALTON;
+static const std::size_t SUBSAMPLES = 4;
+static const auto GENERATOR = generators::modules::THREEFISH;
+
+/* A case passes if the mean absolute error over all channels is small, while *
+ * allowing a few pixels to differ (e.g. due to driver precision variations). */
+static const double MAX_MEAN_ERROR  = 1.0;  // in 8-bit units
+static const double MAX_BAD_PIXELS  = 0.01; // as a fraction
+static const int    BAD_PIXEL_ERROR = 16;   // in 8-bit units
+
+struct Comparison
+{
+    double mean_error, bad_pixels;
+
+    bool passed(void) const
+    {
+        return (mean_error <= MAX_MEAN_ERROR)
+            && (bad_pixels <= MAX_BAD_PIXELS);
+    }
+};
+
+static Comparison compare(const std::vector<uint8_t> &a,
+                          const std::vector<uint8_t> &b)
+{
+    std::size_t total = 0, bad = 0;
+
+    for (std::size_t t = 0; t < a.size(); t += 3)
+    {
+        int worst = 0;
+
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+            int error = std::abs((int)a[t + c] - (int)b[t + c]);
+            worst = std::max(worst, error);
+            total += error;
+        }
+
+        if (worst > BAD_PIXEL_ERROR) ++bad;
+    }
+
+    return Comparison{(double)total / a.size(), (double)bad / (a.size() / 3)};
+}
+
+static bool render(Engine &engine, World &world, const cl::Image &image,
+                   std::vector<uint8_t> &result)
+{
+    /* All of the geometry in view is streamed in before rendering, so that *
+     * the result does not depend on which pages were loaded beforehand.     */
+    if (!world.settle((float)WIDTH / HEIGHT, [&]() { engine.sample(); }))
+        return false;
+
+    /* Only these samples are timed, not the frames rendered to settle  *
+     * (of which there are more or fewer depending on the case and on   *
+     * the pages already loaded, with geometry only partly resident).   */
+    profiler::reset();
+    engine.reset_frame(); // so the seeds do not depend on earlier cases
+    for (std::size_t t = 0; t < SAMPLES; ++t) engine.sample();
+    engine.draw();
+
+    std::vector<uint8_t> rgba(WIDTH * HEIGHT * 4);
+    scheduler::read_image(image, WIDTH, HEIGHT, rgba.data());
+    result = image_io::from_texture(WIDTH, HEIGHT, rgba);
+    return true;
+}
+
+bool regression::run(World &world, const std::string &dir, bool bless)
+{
+    auto first_projection = (projections::modules)0;
+    auto first_integrator = (integrators::modules)0;
+
+    cl::Image2D image = scheduler::alloc_image(WIDTH, HEIGHT);
+    Engine engine(projections::get(first_projection),
+                  integrators::get(first_integrator),
+                  generators::get(GENERATOR),
+                  image);
+    engine.set_subsampler(SUBSAMPLER, SUBSAMPLES);
+    engine.attach(world);
+
+    std::ofstream timings(dir + "/timings.csv");
+    timings << "case,ms_per_sample,mean_error,bad_pixels,status\n";
+    std::size_t failures = 0;
+
+    for (int p = 0; p < projections::modules::COUNT_; ++p)
+    {
+        auto projection = (projections::modules)p;
+        engine.set_module(Engine::Module::PROJECTION,
+                          projections::get(projection));
+
+        for (int i = 0; i < integrators::modules::COUNT_; ++i)
+        {
+            auto integrator = (integrators::modules)i;
+            engine.set_module(Engine::Module::INTEGRATOR,
+                              integrators::get(integrator));
+
+            std::string name = std::string(integrators::name(integrator))
+                             + "_" + projections::name(projection);
+            std::string path = dir + "/" + name + ".ppm";
+
+            std::vector<uint8_t> result;
+            bool rendered = render(engine, world, image, result);
+            profiler::collect(true);
+            double time = profiler::average("render");
+
+            std::vector<uint8_t> reference;
+            std::size_t w, h;
+            std::string status;
+            Comparison cmp{0, 0};
+
+            if (!rendered)
+            {
+                print_error("Case '" + name + "' could not be rendered");
+                status = "fail";
+                ++failures;
+            }
+            else if (!image_io::read_ppm(path, w, h, reference))
+            {
+                if (bless)
+                {
+                    image_io::write_ppm(path, WIDTH, HEIGHT, result);
+                    print_warning("No reference for '" + name + "', saved it");
+                    status = "new";
+                }
+                else
+                {
+                    print_error("No reference for '" + name + "'");
+                    status = "fail";
+                    ++failures;
+                }
+            }
+            else if ((w != WIDTH) || (h != HEIGHT))
+            {
+                print_error("Reference for '" + name + "' has wrong size");
+                status = "fail";
+                ++failures;
+            }
+            else if (!(cmp = compare(result, reference)).passed())
+            {
+                image_io::write_ppm(dir + "/" + name + ".fail.ppm",
+                                    WIDTH, HEIGHT, result);
+                print_error("Case '" + name + "' does not match reference");
+                status = "fail";
+                ++failures;
+            }
+            else status = "pass";
+
+            std::stringstream fmt;
+            fmt << std::fixed << std::setprecision(3);
+            fmt << name << " (" << status << "): " << time << " ms/sample, ";
+            fmt << "mean error " << cmp.mean_error << ", ";
+            fmt << cmp.bad_pixels * 100 << "% bad pixels";
+            print_info(fmt.str());
+
+            timings << std::fixed << std::setprecision(4);
+            timings << name << "," << time << "," << cmp.mean_error << ",";
+            timings << cmp.bad_pixels << "," << status << "\n";
+        }
+    }
+
+    if (failures > 0)
+    {
+        print_error(std::to_string(failures) + " case(s) failed");
+        return false;
+    }
+
+    print_info("All cases passed");
+    return true;
+}
@@ -0,0 +1,224 @@
+#include "render/samples.hpp"
+
+#include "setup/scheduler.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <cmath>
+
+typedef std::vector<cl_float2> Points; // in [0, 1) x [0, 1)
+
+static float radical_inverse(std::size_t index, std::size_t base)
+{
+    float f = 1.0f / base, result = 0;
+
+    while (index > 0)
+    {
+        result += f * (index % base);
+        index /= base;
+        f /= base;
+    }
+
+    return result;
+}
+
+static Points halton(std::size_t count)
+{
+    Points points(count);
+
+    for (std::size_t t = 0; t < count; ++t)
+        points[t] = {{radical_inverse(t, 2), radical_inverse(t, 3)}};
+
+    return points;
+}
+
+/* The first two dimensions of the Sobol sequence: the first one is the base 2 *
+ * radical inverse, and the second one has direction numbers v_i = v_{i-1} ^  *
+ * (v_{i-1} >> 1), from the primitive polynomial x + 1.                       */
+static Points sobol(std::size_t count)
+{
+    Points points(count);
+
+    for (std::size_t t = 0; t < count; ++t)
+    {
+        uint32_t x = 0, y = 0, v = 1u << 31;
+
+        for (uint32_t index = t, bit = 0; index; index >>= 1, ++bit)
+        {
+            if (index & 1)
+            {
+                x ^= 1u << (31 - bit);
+                y ^= v;
+            }
+
+            v ^= v >> 1;
+        }
+
+        const float scale = 1.0f / 16777216; // 24 bits, to stay below one
+        points[t] = {{(x >> 8) * scale, (y >> 8) * scale}};
+    }
+
+    return points;
+}
+
+/* Progressive multi-jittered sequence (Christensen et al., 2018). Every power *
+ * of two prefix is jittered in a grid and stratified in both dimensions, and  *
+ * the sequence is extended by filling the sub-cells each point leaves empty. */
+class PMJSequence
+{
+    public:
+        PMJSequence(std::size_t count) : rng(0x5EED)
+        {
+            std::size_t size = 1;
+            while (size < count) size *= 4;
+
+            points.resize(size);
+            points[0] = {{uniform(rng), uniform(rng)}};
+
+            for (std::size_t n = 1; n < size; n *= 4)
+            {
+                extend_even(n);
+                extend_odd(2 * n);
+            }
+
+            points.resize(count);
+        }
+
+        Points points;
+
+    private:
+        std::mt19937 rng;
+        std::uniform_real_distribution<float> uniform;
+        std::vector<bool> x_strata, y_strata;
+
+        void mark_strata(std::size_t n)
+        {
+            x_strata.assign(2 * n, false);
+            y_strata.assign(2 * n, false);
+
+            for (std::size_t t = 0; t < n; ++t)
+            {
+                x_strata[(std::size_t)(2 * n * points[t].s[0])] = true;
+                y_strata[(std::size_t)(2 * n * points[t].s[1])] = true;
+            }
+        }
+
+        float jitter(std::vector<bool> &strata, std::size_t cell,
+                     std::size_t half, std::size_t grid)
+        {
+            float value;
+            std::size_t stratum;
+
+            do
+            {
+                value = (cell + 0.5f * (half + uniform(rng))) / grid;
+                stratum = std::min((std::size_t)(value * strata.size()),
+                                   strata.size() - 1);
+            }
+            while (strata[stratum]);
+
+            strata[stratum] = true;
+            return value;
+        }
+
+        cl_float2 generate(std::size_t i, std::size_t j, std::size_t x_half,
+                           std::size_t y_half, std::size_t grid)
+        {
+            float x = jitter(x_strata, i, x_half, grid);
+            float y = jitter(y_strata, j, y_half, grid);
+            return {{x, y}};
+        }
+
+        void locate(const cl_float2 &p, std::size_t grid, std::size_t &i,
+                    std::size_t &j, std::size_t &x_half, std::size_t &y_half)
+        {
+            i = (std::size_t)(grid * p.s[0]);
+            j = (std::size_t)(grid * p.s[1]);
+            x_half = (std::size_t)(2 * (grid * p.s[0] - i));
+            y_half = (std::size_t)(2 * (grid * p.s[1] - j));
+        }
+
+        /* From n = 4^k points to 2n: the diagonally opposite sub-cells. */
+        void extend_even(std::size_t n)
+        {
+            std::size_t grid = (std::size_t)(std::sqrt(n) + 0.5);
+            mark_strata(n);
+
+            for (std::size_t t = 0; t < n; ++t)
+            {
+                std::size_t i, j, x_half, y_half;
+                locate(points[t], grid, i, j, x_half, y_half);
+                points[n + t] = generate(i, j, 1 - x_half, 1 - y_half, grid);
+            }
+        }
+
+        /* From n = 2 * 4^k points to 2n: the two remaining sub-cells. */
+        void extend_odd(std::size_t n)
+        {
+            std::size_t grid = (std::size_t)(std::sqrt(n / 2) + 0.5);
+            mark_strata(n);
+
+            for (std::size_t t = 0; t < n / 2; ++t)
+            {
+                std::size_t i, j, x_half, y_half;
+                locate(points[t], grid, i, j, x_half, y_half);
+
+                if (uniform(rng) > 0.5f) x_half = 1 - x_half;
+                else                     y_half = 1 - y_half;
+
+                points[n + t] = generate(i, j, x_half, y_half, grid);
+                points[n + n / 2 + t] = generate(i, j, 1 - x_half,
+                                                 1 - y_half, grid);
+            }
+        }
+};
+
+SampleTable::SampleTable(Pattern pattern, std::size_t count)
+{
+    set(pattern, count);
+}
+
+void SampleTable::set(Pattern pattern, std::size_t count)
+{
+    if (count == 0) throw std::logic_error("Sample table cannot be empty");
+
+    Points points;
+
+    switch (pattern)
+    {
+        case   NONE: points = Points(1, {{0.5f, 0.5f}}); break;
+        case HALTON: points = halton(count);             break;
+        case  SOBOL: points = sobol(count);              break;
+        case    PMJ: points = PMJSequence(count).points; break;
+        default    : throw std::logic_error("Unknown sample pattern");
+    }
+
+    for (auto &p : points) // offsets from the pixel
+        p = {{p.s[0] - 0.5f, p.s[1] - 0.5f}};
+
+    this->count = points.size();
+    mem = scheduler::alloc_buffer(points.size() * sizeof(cl_float2),
+                                  CL_MEM_READ_ONLY);
+    scheduler::write(mem, 0, points.size() * sizeof(cl_float2),
+                     points.data(), true);
+}
+
+void SampleTable::notify_cb(std::map<std::string, cl::Kernel> &kernels)
+{
+    scheduler::set_arg(kernels["render"], "smp_data", mem);
+    scheduler::set_arg(kernels["render"], "smp_count", count);
+}
+
+const char *SampleTable::name(Pattern pattern)
+{
+    switch (pattern)
+    {
+        case   NONE: return "none";
+        case HALTON: return "halton";
+        case  SOBOL: return "sobol";
+        case    PMJ: return "pmj";
+        default    : throw std::logic_error("Unknown sample pattern");
+    }
+}
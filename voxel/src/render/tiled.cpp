@@ -0,0 +1,89 @@
+#include "render/tiled.hpp"
+#include "render/image_io.hpp"
+#include "render/engine.hpp"
+
+#include "modules/projections.hpp"
+#include "modules/integrators.hpp"
+#include "modules/generators.hpp"
+
+#include "setup/scheduler.hpp"
+#include "gui/log.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+static const auto SUBSAMPLER = SampleTable::Pattern::HALTON;
+static const std::size_t SUBSAMPLES = 4;
+static const auto PROJECTION = projections::modules::PERSPECTIVE;
+static const auto INTEGRATOR = integrators::modules::AO;
+static const auto GENERATOR = generators::modules::THREEFISH;
+
+bool tiled::render(World &world, std::size_t width, std::size_t height,
+                   std::size_t samples, const std::string &path,
+                   std::size_t tile)
+{
+    if ((width == 0) || (height == 0) || (samples == 0) || (tile == 0))
+    {
+        print_error("Image dimensions and sample count must be positive");
+        return false;
+    }
+
+    /* The device only ever holds a single tile (the denoiser is left off, as *
+     * it would not see across tile boundaries and so would show seams).     */
+    cl::Image2D image = scheduler::alloc_image(tile, tile);
+    Engine engine(projections::get(PROJECTION),
+                  integrators::get(INTEGRATOR),
+                  generators::get(GENERATOR),
+                  image);
+    engine.set_subsampler(SUBSAMPLER, SUBSAMPLES);
+    engine.attach(world);
+
+    image_io::PPMStream stream(path, width, height);
+    std::vector<uint8_t> rgba(tile * tile * 4);
+
+    for (std::size_t y = 0; y < height; y += tile)
+    {
+        std::size_t h = std::min(tile, height - y);
+        std::vector<uint8_t> band(width * h * 3);
+
+        for (std::size_t x = 0; x < width; x += tile)
+        {
+            std::size_t w = std::min(tile, width - x);
+
+            engine.set_tile(x, y, w, h, width, height);
+
+            /* Stream in the geometry seen by the tile before rendering it. */
+            if (!world.settle((float)width / height,
+                              [&]() { engine.sample(); })) return false;
+            engine.clear_frame();
+
+            for (std::size_t t = 0; t < samples; ++t) engine.sample();
+            engine.draw();
+
+            scheduler::read_image(image, tile, tile, rgba.data());
+            auto rgb = image_io::from_texture(tile, h, rgba);
+
+            for (std::size_t r = 0; r < h; ++r)
+                std::copy_n(&rgb[r * tile * 3], w * 3,
+                            &band[(r * width + x) * 3]);
+        }
+
+        if (!stream.write_rows(band))
+        {
+            print_error("Failed to write to '" + path + "'");
+            return false;
+        }
+
+        print_info("Rendered " + std::to_string(y + h) + " of "
+                 + std::to_string(height) + " rows");
+    }
+
+    const PagedGeometry::Stats &stats = world.pages().stats();
+    print_info("Streamed " + std::to_string(stats.uploaded >> 20) + " MiB of "
+             + "geometry (" + std::to_string(stats.read >> 20) + " MiB read, "
+             + std::to_string(stats.misses) + " page misses, "
+             + std::to_string(stats.evicted) + " evictions)");
+
+    return stream.complete();
+}
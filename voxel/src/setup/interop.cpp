@@ -1,4 +1,5 @@
 #include "setup/scheduler.hpp"
+#include "setup/profiler.hpp"
 #include "setup/interop.hpp"
 
 #include <SFML/OpenGL.hpp>
@@ -72,12 +73,14 @@ void interop::synchronize_cl(const cl::ImageGL &image)
 {
     std::vector<cl::Memory> img(1, image);
     auto v_queue = scheduler::get_queue();
-    v_queue.enqueueAcquireGLObjects(&img);
+    v_queue.enqueueAcquireGLObjects(&img, nullptr,
+                                    profiler::track("acquire"));
 }
 
 void interop::synchronize_gl(const cl::ImageGL &image)
 {
     std::vector<cl::Memory> img(1, image);
     auto v_queue = scheduler::get_queue();
-    v_queue.enqueueReleaseGLObjects(&img);
+    v_queue.enqueueReleaseGLObjects(&img, nullptr,
+                                    profiler::track("release"));
 }
@@ -0,0 +1,147 @@
+#include "setup/prng_bench.hpp"
+#include "setup/scheduler.hpp"
+
+#include "modules/generators.hpp"
+#include "gui/log.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+static const std::size_t SPEED_ITEMS = 1 << 18, SPEED_ROUNDS = 256;
+static const std::size_t SPEED_RUNS = 8;
+static const std::size_t STATS_ITEMS = 1 << 14, STATS_ROUNDS = 1024;
+static const std::size_t BINS = 16; // must match prng_bench.cl
+
+/* Loose bounds on the statistics, which any reasonable generator passes on so *
+ * many numbers (each is several standard deviations away from its target).  */
+static const double MAX_MEAN_ERROR = 1e-3;   // from 1/2
+static const double MAX_VAR_ERROR  = 1e-3;   // from 1/12
+static const double MAX_CORRELATION = 1e-2;  // lag one
+static const double MAX_BIT_BIAS   = 1e-3;   // from 1/2
+static const double MAX_CHI_SQUARE = 50;     // 15 degrees of freedom
+
+static double measure_speed(std::map<std::string, cl::Kernel> &kernels)
+{
+    cl::Kernel &kernel = kernels["prng_speed"];
+    cl::Buffer sink = scheduler::alloc_buffer(SPEED_ITEMS * 16,
+                                              CL_MEM_WRITE_ONLY);
+    cl_uint4 result;
+
+    scheduler::set_arg(kernel, "sink", sink);
+    scheduler::set_arg(kernel, "items", (cl_uint)SPEED_ITEMS);
+    scheduler::set_arg(kernel, "rounds", (cl_uint)SPEED_ROUNDS);
+    scheduler::set_arg(kernel, "seed", (cl_ulong)0);
+    scheduler::run(kernel, cl::NDRange(SPEED_ITEMS)); // warm up
+    scheduler::read(sink, 0, sizeof(result), &result, true);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t t = 0; t < SPEED_RUNS; ++t)
+    {
+        scheduler::set_arg(kernel, "seed", (cl_ulong)(t + 1));
+        scheduler::run(kernel, cl::NDRange(SPEED_ITEMS));
+    }
+
+    scheduler::read(sink, 0, sizeof(result), &result, true);
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+
+    double numbers = 4.0 * SPEED_ITEMS * SPEED_ROUNDS * SPEED_RUNS;
+    return numbers / elapsed.count();
+}
+
+static bool measure_stats(std::map<std::string, cl::Kernel> &kernels,
+                          std::stringstream &report)
+{
+    cl::Kernel &kernel = kernels["prng_stats"];
+    std::vector<cl_float4> moments(STATS_ITEMS);
+    std::vector<cl_uint> counts(STATS_ITEMS * (BINS + 1));
+
+    cl::Buffer moments_mem = scheduler::alloc_buffer(moments.size() * 16,
+                                                     CL_MEM_WRITE_ONLY);
+    cl::Buffer counts_mem = scheduler::alloc_buffer(counts.size() * 4,
+                                                    CL_MEM_WRITE_ONLY);
+
+    scheduler::set_arg(kernel, "moments", moments_mem);
+    scheduler::set_arg(kernel, "counts", counts_mem);
+    scheduler::set_arg(kernel, "items", (cl_uint)STATS_ITEMS);
+    scheduler::set_arg(kernel, "rounds", (cl_uint)STATS_ROUNDS);
+    scheduler::set_arg(kernel, "seed", (cl_ulong)0);
+    scheduler::run(kernel, cl::NDRange(STATS_ITEMS));
+    scheduler::read(moments_mem, 0, moments.size() * 16, moments.data());
+    scheduler::read(counts_mem, 0, counts.size() * 4, counts.data(), true);
+
+    double sum = 0, sum_sq = 0, sum_lag = 0, ones = 0;
+    std::vector<double> bins(BINS, 0);
+
+    for (std::size_t t = 0; t < STATS_ITEMS; ++t)
+    {
+        sum += moments[t].s[0];
+        sum_sq += moments[t].s[1];
+        sum_lag += moments[t].s[2];
+
+        for (std::size_t b = 0; b < BINS; ++b)
+            bins[b] += counts[t * (BINS + 1) + b];
+
+        ones += counts[t * (BINS + 1) + BINS];
+    }
+
+    double n = 4.0 * STATS_ITEMS * STATS_ROUNDS;
+    double mean = sum / n, var = sum_sq / n - mean * mean;
+    double correlation = (sum_lag / n - mean * mean) / var;
+    double bit_ratio = ones / (n * 32);
+
+    double chi_square = 0;
+    for (double count : bins)
+        chi_square += (count - n / BINS) * (count - n / BINS) / (n / BINS);
+
+    report << std::fixed << std::setprecision(5);
+    report << "mean " << mean << ", variance " << var;
+    report << ", correlation " << correlation << ", one bits " << bit_ratio;
+    report << std::setprecision(1) << ", chi-square " << chi_square;
+
+    return (std::abs(mean - 0.5) <= MAX_MEAN_ERROR)
+        && (std::abs(var - 1.0 / 12) <= MAX_VAR_ERROR)
+        && (std::abs(correlation) <= MAX_CORRELATION)
+        && (std::abs(bit_ratio - 0.5) <= MAX_BIT_BIAS)
+        && (chi_square <= MAX_CHI_SQUARE);
+}
+
+bool prng_bench::run(void)
+{
+    std::size_t failures = 0;
+
+    for (int g = 0; g < generators::modules::COUNT_; ++g)
+    {
+        auto generator = (generators::modules)g;
+        std::string name = generators::name(generator);
+
+        cl::Program program = scheduler::link({
+            scheduler::acquire("core/prng_lib"),
+            scheduler::acquire("prng_bench"),
+            generators::get(generator)
+        }, "prng_bench");
+        auto kernels = scheduler::get_all(program);
+
+        double speed = measure_speed(kernels);
+        std::stringstream report;
+        bool passed = measure_stats(kernels, report);
+
+        std::stringstream fmt;
+        fmt << name << ": " << std::fixed << std::setprecision(1);
+        fmt << speed * 1e-9 << " billion numbers/second, " << report.str();
+
+        if (passed) print_info(fmt.str());
+        else
+        {
+            print_error(fmt.str() + " (FAILED)");
+            ++failures;
+        }
+    }
+
+    return failures == 0;
+}
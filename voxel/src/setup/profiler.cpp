@@ -0,0 +1,157 @@
+#include "setup/profiler.hpp"
+#include "setup/tracer.hpp"
+#include "gui/log.hpp"
+
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+
+/* Commands are first queued as pending (their event has not completed yet) and
+ * are moved into the timing ring once the device is done with them. Since the
+ * command queue is in-order, pending commands always complete in order.      */
+
+static const std::size_t PENDING_SIZE = 256;
+static const std::size_t TIMINGS_SIZE = 1024;
+
+struct Pending
+{
+    std::string name;
+    cl::Event event;
+};
+
+struct Timing
+{
+    std::string name;
+    cl_ulong start, end;
+};
+
+struct Total
+{
+    double time; // in ms
+    std::size_t count;
+};
+
+static bool active = false;
+
+static std::vector<Pending> pending(PENDING_SIZE);
+static std::size_t pending_head = 0, pending_count = 0;
+
+static std::vector<Timing> timings(TIMINGS_SIZE);
+static std::size_t timings_head = 0, timings_count = 0;
+
+static std::map<std::string, Total> totals;
+
+void profiler::enable(void)
+{
+    active = true;
+}
+
+bool profiler::enabled(void)
+{
+    return active;
+}
+
+cl::Event *profiler::track(const std::string &name)
+{
+    if (!active) return nullptr;
+
+    if (pending_count == PENDING_SIZE)
+        collect(true); // ring is full, we must make room
+
+    std::size_t index = (pending_head + pending_count++) % PENDING_SIZE;
+    pending[index].name = name;
+    pending[index].event = cl::Event();
+    return &pending[index].event;
+}
+
+static bool is_complete(const cl::Event &event)
+{
+    return event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>() == CL_COMPLETE;
+}
+
+static void push_timing(const std::string &name, cl_ulong start, cl_ulong end)
+{
+    std::size_t index = (timings_head + timings_count) % TIMINGS_SIZE;
+    if (timings_count < TIMINGS_SIZE) ++timings_count;
+    else timings_head = (timings_head + 1) % TIMINGS_SIZE;
+
+    timings[index] = Timing{name, start, end};
+
+    tracer::device(name, start, end);
+
+    Total &total = totals[name];
+    total.time += (end - start) * 1e-6;
+    ++total.count;
+}
+
+void profiler::collect(bool wait)
+{
+    while (pending_count > 0)
+    {
+        Pending &cmd = pending[pending_head];
+
+        if (cmd.event() != nullptr) /* Null if the enqueue call failed. */
+        {
+            if (wait) cmd.event.wait();
+            else if (!is_complete(cmd.event)) break;
+
+            const cl::Event &e = cmd.event;
+            auto start = e.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+            auto end   = e.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+            push_timing(cmd.name, start, end);
+        }
+
+        cmd.event = cl::Event(); // release the event
+        pending_head = (pending_head + 1) % PENDING_SIZE;
+        --pending_count;
+    }
+}
+
+double profiler::average(const std::string &name)
+{
+    double time = 0;
+    std::size_t count = 0;
+
+    for (std::size_t t = 0; t < timings_count; ++t)
+    {
+        const Timing &timing = timings[(timings_head + t) % TIMINGS_SIZE];
+        if (timing.name != name) continue;
+
+        time += (timing.end - timing.start) * 1e-6;
+        ++count;
+    }
+
+    return count ? time / count : 0;
+}
+
+void profiler::reset(void)
+{
+    collect(true);
+    timings_head = timings_count = 0;
+    totals.clear();
+}
+
+void profiler::summary(void)
+{
+    collect(true);
+
+    if (totals.empty())
+    {
+        print_info("Profiler recorded no commands");
+        return;
+    }
+
+    print_info("Profiler summary follows");
+
+    for (auto &it : totals)
+    {
+        std::stringstream fmt;
+        fmt << std::fixed << std::setprecision(3);
+        fmt << "  " << std::left << std::setw(16) << it.first;
+        fmt << " x" << it.second.count << ", avg ";
+        fmt << it.second.time / it.second.count << " ms, total ";
+        fmt << it.second.time << " ms";
+        print_info(fmt.str());
+    }
+}
@@ -1,4 +1,6 @@
 #include "setup/scheduler.hpp"
+#include "setup/profiler.hpp"
+#include "setup/tracer.hpp"
 #include "gui/log.hpp"
 
 #include <iostream>
@@ -21,9 +23,21 @@ cl::CommandQueue scheduler::get_queue(void)
 
 void scheduler::setup(const cl::Device &dev, cl_context_properties *options)
 {
+    cl_command_queue_properties properties = 0;
+    if (profiler::enabled()) properties |= CL_QUEUE_PROFILING_ENABLE;
+
     context = cl::Context(std::vector<cl::Device>(1, dev), options);
-    queue   = cl::CommandQueue(context, dev);
+    queue   = cl::CommandQueue(context, dev, properties);
     device  = dev;
+
+    if (tracer::enabled() && profiler::enabled())
+    {
+        cl::Event marker; // to map device time onto host time
+        queue.enqueueMarkerWithWaitList(nullptr, &marker);
+        marker.wait();
+
+        tracer::calibrate(marker.getProfilingInfo<CL_PROFILING_COMMAND_END>());
+    }
 }
 
 static std::string load(const std::string &path)
@@ -38,6 +52,7 @@ cl::Program scheduler::acquire(const std::string &name,
                                const std::string &args,
                                const std::string &prefix)
 {
+    tracer::Zone zone("acquire '" + name + "'");
     cl::Program program;
     std::string source;
 
@@ -69,6 +84,7 @@ cl::Program scheduler::acquire(const std::string &name,
 cl::Program scheduler::link(const std::vector<cl::Program> &programs,
                             const std::string &name)
 {
+    tracer::Zone zone("link '" + name + "'");
     print_info("Attempting to link '" + name + "'");
     cl::Program program = cl::linkProgram(programs);
     print_info("Successfully linked");
@@ -115,14 +131,43 @@ std::size_t scheduler::get_arg(const cl::Kernel &kernel,
     {
         if (name == "frm_info") return 0;
         if (name == "frm_data") return 1;
-        if (name == "geometry") return 2;
-        if (name == "observer") return 3;
+        if (name == "ftr_data") return 2;
+        if (name == "mat_data") return 3;
+        if (name == "smp_data") return 4;
+        if (name == "smp_count") return 5;
+        if (name == "geometry") return 6;
+        if (name == "observer") return 7;
+        if (name == "mtl_table") return 8;
+    }
+    else if (kernel_name == "prng_speed")
+    {
+        if (name == "sink") return 0;
+        if (name == "items") return 1;
+        if (name == "rounds") return 2;
+        if (name == "seed") return 3;
+    }
+    else if (kernel_name == "prng_stats")
+    {
+        if (name == "moments") return 0;
+        if (name == "counts") return 1;
+        if (name == "items") return 2;
+        if (name == "rounds") return 3;
+        if (name == "seed") return 4;
+    }
+    else if (kernel_name == "denoise")
+    {
+        if (name == "frm_info") return 0;
+        if (name == "ftr_data") return 1;
+        if (name == "dns_src") return 2;
+        if (name == "dns_dst") return 3;
+        if (name == "dns_step") return 4;
     }
     else if (kernel_name == "interop_copy")
     {
         if (name == "frm_info") return 0;
         if (name == "frm_data") return 1;
-        if (name == "tex_data") return 2;
+        if (name == "pst_info") return 2;
+        if (name == "tex_data") return 3;
     }
 #else
     std::size_t num_args = kernel.getInfo<CL_KERNEL_NUM_ARGS>();
@@ -150,9 +195,18 @@ void scheduler::run(const cl::Kernel &kernel,
     // round up to nearest local size
     cl::NDRange global = dimensions[0] - dimensions[0] % local + local;
 
-    queue.finish();
+    cl::Event *event = nullptr;
+    if (profiler::enabled())
+        event = profiler::track(kernel.getInfo<CL_KERNEL_FUNCTION_NAME>());
+
+    {
+        tracer::Zone zone("finish");
+        queue.finish();
+    }
+
     queue.enqueueNDRangeKernel(kernel, cl::NullRange, global,
-                               cl::NullRange /* Find local size */);
+                               cl::NullRange /* Find local size */,
+                               nullptr, event);
 }
 
 void scheduler::flush(void)
@@ -165,6 +219,29 @@ cl::ImageGL scheduler::alloc_gl_image(cl_mem_flags flags, GLuint texture)
     return cl::ImageGL(context, flags, GL_TEXTURE_2D, 0, texture);
 }
 
+cl::Image2D scheduler::alloc_image(std::size_t width, std::size_t height)
+{
+    cl::ImageFormat format(CL_RGBA, CL_UNORM_INT8); // same as interop
+    return cl::Image2D(context, CL_MEM_WRITE_ONLY, format, width, height);
+}
+
+void scheduler::read_image(const cl::Image &image, std::size_t width,
+                           std::size_t height, void *ptr)
+{
+    cl::size_t<3> origin;
+    origin[0] = 0;
+    origin[1] = 0;
+    origin[2] = 0;
+
+    cl::size_t<3> region;
+    region[0] = width;
+    region[1] = height;
+    region[2] = 1;
+
+    queue.enqueueReadImage(image, true, origin, region, 0, 0, ptr, nullptr,
+                           profiler::track("read"));
+}
+
 void scheduler::clear_gl_image(cl::Image &image, std::size_t width, std::size_t height)
 {
     cl_float4 u;
@@ -183,7 +260,8 @@ void scheduler::clear_gl_image(cl::Image &image, std::size_t width, std::size_t
     region[1] = height;
     region[2] = 1;
 
-    queue.enqueueFillImage(image, u, origin, region);
+    queue.enqueueFillImage(image, u, origin, region, nullptr,
+                           profiler::track("clear"));
 }
 
 void scheduler::clear_buffer(cl::Buffer &buffer, std::size_t size)
@@ -194,7 +272,8 @@ void scheduler::clear_buffer(cl::Buffer &buffer, std::size_t size)
     u.s[2] = 0;
     u.s[3] = 0;
 
-    queue.enqueueFillBuffer(buffer, u, 0, size);
+    queue.enqueueFillBuffer(buffer, u, 0, size, nullptr,
+                            profiler::track("clear"));
 }
 
 cl::Buffer scheduler::alloc_buffer(std::size_t size, cl_mem_flags flags,
@@ -206,11 +285,25 @@ cl::Buffer scheduler::alloc_buffer(std::size_t size, cl_mem_flags flags,
 void scheduler::write(const cl::Buffer &buffer, std::size_t offset, std::size_t size,
                       const void *ptr, bool blocking)
 {
-    queue.enqueueWriteBuffer(buffer, blocking, offset, size, ptr);
+    tracer::Zone zone("write");
+    queue.enqueueWriteBuffer(buffer, blocking, offset, size, ptr, nullptr,
+                             profiler::track("write"));
 }
 
 void scheduler::read(const cl::Buffer &buffer, std::size_t offset, std::size_t size,
                      void *ptr, bool blocking)
 {
-    queue.enqueueReadBuffer(buffer, blocking, offset, size, ptr);
+    queue.enqueueReadBuffer(buffer, blocking, offset, size, ptr, nullptr,
+                            profiler::track("read"));
+}
+
+void *scheduler::map(const cl::Buffer &buffer, std::size_t size,
+                     cl_map_flags flags)
+{
+    return queue.enqueueMapBuffer(buffer, CL_TRUE, flags, 0, size);
+}
+
+void scheduler::unmap(const cl::Buffer &buffer, void *ptr)
+{
+    queue.enqueueUnmapMemObject(buffer, ptr);
 }
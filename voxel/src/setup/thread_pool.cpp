@@ -0,0 +1,82 @@
+#include "setup/thread_pool.hpp"
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : task(nullptr), count(0), next(0), pending(0), generation(0),
+      stopping(false)
+{
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1; // which may not be known
+
+    for (std::size_t t = 1; t < threads; ++t)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wake.notify_all();
+    for (std::thread &worker : workers) worker.join();
+}
+
+std::size_t ThreadPool::size(void) const
+{
+    return workers.size() + 1;
+}
+
+/* Runs iterations of the current loop until there are none left to start. */
+void ThreadPool::drain(std::unique_lock<std::mutex> &lock)
+{
+    while (next < count)
+    {
+        std::size_t index = next++;
+        lock.unlock();
+
+        std::exception_ptr failure;
+        try { (*task)(index); }
+        catch (...) { failure = std::current_exception(); }
+
+        lock.lock();
+        if (failure && !error) error = failure;
+        if (--pending == 0) done.notify_all();
+    }
+}
+
+void ThreadPool::work(void)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::size_t seen = generation;
+
+    while (true)
+    {
+        wake.wait(lock, [&]{ return stopping || (generation != seen); });
+        if (stopping) return;
+
+        seen = generation;
+        drain(lock);
+    }
+}
+
+void ThreadPool::run(std::size_t count,
+                     const std::function<void(std::size_t)> &task)
+{
+    if (count == 0) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    this->task = &task;
+    this->count = count;
+    next = 0;
+    pending = count;
+    error = nullptr;
+    ++generation;
+
+    wake.notify_all();
+    drain(lock);
+    done.wait(lock, [&]{ return pending == 0; });
+
+    this->task = nullptr;
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,147 @@
+#include "setup/profiler.hpp"
+#include "setup/tracer.hpp"
+#include "gui/log.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+/* All timestamps are in microseconds since the tracer was enabled, which is *
+ * what the trace event format expects; device timestamps are in nanoseconds *
+ * on the device clock and are shifted by an offset found by calibration.     */
+
+typedef std::chrono::steady_clock host_clock;
+
+enum Track
+{
+    HOST   = 1,
+    DEVICE = 2,
+};
+
+struct Event
+{
+    std::string name;
+    double ts, dur;
+    Track tid;
+};
+
+static bool active = false;
+static std::string output;
+static std::size_t requested;
+static std::size_t completed;
+static host_clock::time_point epoch;
+static double device_offset = 0;
+static std::vector<Event> events;
+
+static double host_now(void)
+{
+    auto elapsed = host_clock::now() - epoch;
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+void tracer::enable(const std::string &path, std::size_t frames)
+{
+    active = frames > 0;
+    output = path;
+    requested = frames;
+    completed = 0;
+    epoch = host_clock::now();
+    events.clear();
+}
+
+bool tracer::enabled(void)
+{
+    return active;
+}
+
+void tracer::calibrate(cl_ulong device_ns)
+{
+    device_offset = host_now() - device_ns * 1e-3;
+}
+
+void tracer::device(const std::string &name, cl_ulong start, cl_ulong end)
+{
+    if (!active) return;
+
+    double ts = start * 1e-3 + device_offset;
+    events.push_back(Event{name, ts, (end - start) * 1e-3, DEVICE});
+}
+
+static std::string escape(const std::string &s)
+{
+    std::string out;
+
+    for (char c : s)
+    {
+        if ((c == '"') || (c == '\\')) out += '\\';
+        if (c != '\0') out += c;
+    }
+
+    return out;
+}
+
+static void write_track_name(std::ofstream &file, Track tid,
+                             const std::string &name)
+{
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << tid << ",\"args\":{\"name\":\"" << name << "\"}},\n";
+}
+
+static void write_trace(void)
+{
+    std::ofstream file(output);
+    if (!file)
+    {
+        print_error("Failed to open trace file '" + output + "'");
+        return;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[\n";
+    write_track_name(file, HOST,   "Host");
+    write_track_name(file, DEVICE, "Device");
+
+    for (std::size_t t = 0; t < events.size(); ++t)
+    {
+        const Event &e = events[t];
+        file << "{\"name\":\"" << escape(e.name) << "\",\"ph\":\"X\""
+             << ",\"pid\":1,\"tid\":" << e.tid
+             << ",\"ts\":" << e.ts << ",\"dur\":" << e.dur << "}";
+        file << ((t + 1 < events.size()) ? ",\n" : "\n");
+    }
+
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+    print_info("Wrote " + std::to_string(completed) + " frames of trace "
+             + "to '" + output + "'");
+}
+
+void tracer::frame(void)
+{
+    static bool first = true; // startup is not a frame
+
+    if (!active) return;
+    if (first) { first = false; return; }
+    if (++completed == requested) finish();
+}
+
+void tracer::finish(void)
+{
+    if (!active) return;
+
+    profiler::collect(true); // wait for the device
+    active = false;
+    write_trace();
+    events.clear();
+}
+
+tracer::Zone::Zone(const std::string &name)
+    : name(name), start(active ? host_now() : 0)
+{
+
+}
+
+tracer::Zone::~Zone()
+{
+    if (active) events.push_back(Event{name, start, host_now() - start, HOST});
+}
@@ -0,0 +1,383 @@
+#include "world/geometry.hpp"
+
+#include "setup/scheduler.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+/* The buffer holds the header, then the root node pointer of each cell in *
+ * the chunk grid (padded to a whole node), then the page slots, and lastly *
+ * the usage stamp of each slot (the frame it was last used by any kernel). *
+ * The slots come after a single unused node, so that no node has pointer  *
+ * zero (which stands for an empty octant, and would hide its subtree).    */
+
+/* Prefetching loads at most a few pages per update so as not to stall the *
+ * frame, and may only evict pages left unused for a couple of seconds.    */
+static const std::size_t MAX_PREFETCH = 4;
+static const cl_uint PREFETCH_AGE = 120; // in frames
+
+/* The number of pages decompressed and uploaded at once (which is the size *
+ * of the pinned staging buffer they are decompressed into).               */
+static const std::size_t STAGING_PAGES = 64;
+
+const uint32_t PagedGeometry::NO_SLOT;
+
+std::size_t PagedGeometry::page_size(void)
+{
+    return PAGE_NODES * sizeof(Node);
+}
+
+PagedGeometry::PagedGeometry(const std::string &path, std::size_t slots)
+    : file(path),
+      grid(file.grid_width(), file.grid_height(), file.grid_depth()),
+      cell_of(file.page_count(), ChunkGrid::NO_CHUNK),
+      children(file.page_count()), slot_of(file.page_count(), NO_SLOT),
+      page_in(slots, NO_SLOT), stamps(slots, 0), compressed(STAGING_PAGES),
+      counters{0, 0, 0, 0, 0, 0}
+{
+    if (file.page_nodes() != PAGE_NODES)
+        throw std::runtime_error("Page file has the wrong page size");
+
+    if (slots == 0) throw std::logic_error("Page budget is too small");
+
+    for (uint32_t cell = 0; cell < grid.cells(); ++cell)
+    {
+        uint32_t chunk = file.chunk(cell);
+        if (chunk == PageFile::NO_PAGE) continue;
+
+        if ((chunk >= file.page_count())
+         || (file.info(chunk).parent != PageFile::NO_PAGE))
+            throw std::runtime_error("Chunk is not a tree of the page file");
+
+        grid.set_chunk(cell, chunk);
+        cell_of[chunk] = cell;
+    }
+
+    for (uint32_t p = 0; p < file.page_count(); ++p)
+        if (file.info(p).parent != PageFile::NO_PAGE)
+            children[file.info(p).parent].push_back(p);
+
+    for (uint32_t slot = (uint32_t)slots; slot-- > 0; )
+        free_slots.push_back(slot);
+
+    mem = scheduler::alloc_buffer(node_offset((uint32_t)slots, 0)
+                                + slots * sizeof(cl_uint), CL_MEM_READ_WRITE);
+
+    header = Header{1, (cl_uint)slots, {grid.width(), grid.height(),
+                    grid.depth()}, {0}, {0}};
+    scheduler::write(mem, 0, sizeof(header), &header, true);
+
+    std::vector<cl_uint> cells(grid.cells(), ChunkGrid::NO_CHUNK);
+    scheduler::write(mem, cell_offset(0), cells.size() * sizeof(cl_uint),
+                     cells.data(), true);
+    scheduler::write(mem, node_offset((uint32_t)slots, 0),
+                     slots * sizeof(cl_uint), stamps.data(), true);
+
+    /* Memory allocated by the implementation for a buffer is usually pinned *
+     * (i.e. page-locked), so uploads from it can go straight to the device. */
+    staging = scheduler::alloc_buffer(STAGING_PAGES * page_size(),
+                                      CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR);
+    staged = (Node *)scheduler::map(staging, STAGING_PAGES * page_size(),
+                                    CL_MAP_WRITE);
+}
+
+PagedGeometry::~PagedGeometry()
+{
+    scheduler::unmap(staging, staged);
+}
+
+std::size_t PagedGeometry::cell_offset(uint32_t cell) const
+{
+    return sizeof(Header) + cell * sizeof(cl_uint);
+}
+
+uint32_t PagedGeometry::node_pointer(uint32_t slot, uint32_t node) const
+{
+    return 1 + slot * PAGE_NODES + node;
+}
+
+std::size_t PagedGeometry::node_offset(uint32_t slot, uint32_t node) const
+{
+    std::size_t nodes = (grid.cells() * sizeof(cl_uint) + sizeof(Node) - 1)
+                      / sizeof(Node); // taken up by the grid cells
+    return sizeof(Header) + (nodes + node_pointer(slot, node)) * sizeof(Node);
+}
+
+/* Points the child pointers in the parent page which refer to a page at its *
+ * subtrees in a slot, or back at the page itself if the slot is NO_SLOT (or *
+ * the grid cell's pointer instead, if the page is the root page of a chunk). */
+void PagedGeometry::link(uint32_t page_id, uint32_t slot)
+{
+    const PageFile::PageInfo &info = file.info(page_id);
+
+    for (uint32_t c = 0; c < 8; ++c)
+    {
+        if (info.entry[c] == PageFile::NO_ENTRY) continue;
+
+        std::size_t offset = (info.parent == PageFile::NO_PAGE)
+                           ? cell_offset(cell_of[page_id])
+                           : node_offset(slot_of[info.parent], info.node)
+                           + c * sizeof(cl_uint);
+        cl_uint pointer = page_id | PAGE_FLAG;
+        if (slot != NO_SLOT) pointer = node_pointer(slot, info.entry[c]);
+        else if (info.parent == PageFile::NO_PAGE)
+            pointer = ChunkGrid::NO_CHUNK;
+
+        scheduler::write(mem, offset, sizeof(pointer), &pointer, true);
+        counters.uploaded += sizeof(pointer);
+    }
+}
+
+/* Makes a page resident in a free slot, although it is only uploaded (and *
+ * linked into its tree) by the next flush().                               */
+void PagedGeometry::place(uint32_t page_id)
+{
+    uint32_t slot = free_slots.back();
+    free_slots.pop_back();
+
+    page_in[slot] = page_id;
+    slot_of[page_id] = slot;
+    pending.push_back(Placement{page_id, slot});
+
+    /* The stamp of the slot's previous page is reset, so that the page is *
+     * not evicted until it has had a chance to be used.                   */
+    stamps[slot] = header.frame;
+}
+
+void PagedGeometry::flush(void)
+{
+    /* Pages can have been evicted again since they were placed (to make *
+     * room for others), in which case their slot may have been reused.  */
+    std::vector<Placement> batch;
+    for (const Placement &placed : pending)
+        if (slot_of[placed.page] == placed.slot) batch.push_back(placed);
+    pending.clear();
+
+    for (std::size_t first = 0; first < batch.size(); first += STAGING_PAGES)
+    {
+        std::size_t count = std::min(STAGING_PAGES, batch.size() - first);
+
+        for (std::size_t t = 0; t < count; ++t)
+        {
+            file.read(batch[first + t].page, compressed[t]);
+            counters.read += compressed[t].size();
+        }
+
+        std::size_t used[STAGING_PAGES];
+
+        workers.run(count, [&](std::size_t t)
+        {
+            Node *page = staged + t * PAGE_NODES;
+            used[t] = file.decode(compressed[t], page);
+
+            /* Pointers within the page are relocated to its slot (others *
+             * refer to other pages, which are not resident yet).        */
+            for (Node *node = page; node != page + used[t]; ++node)
+                for (uint32_t &child : node->child)
+                    if (is_node(child))
+                        child = node_pointer(batch[first + t].slot, child);
+        });
+
+        /* Only the nodes in use are uploaded, as nothing points past them. */
+        for (std::size_t t = 0; t < count; ++t)
+        {
+            uint32_t slot = batch[first + t].slot;
+
+            scheduler::write(mem, node_offset(slot, 0),
+                             used[t] * sizeof(Node), staged + t * PAGE_NODES);
+            scheduler::write(mem, node_offset(header.slots, 0) + slot
+                           * sizeof(cl_uint), sizeof(cl_uint), &stamps[slot]);
+            counters.uploaded += used[t] * sizeof(Node);
+        }
+
+        /* Only now do the parents point to the pages rather than request *
+         * them (the writes being done in order).                        */
+        for (std::size_t t = 0; t < count; ++t)
+            link(batch[first + t].page, batch[first + t].slot);
+
+        scheduler::flush(); // before the staging buffer gets overwritten
+    }
+}
+
+void PagedGeometry::evict(uint32_t page_id)
+{
+    /* Descendants are only reachable through this page, so they must go. */
+    for (uint32_t child : children[page_id])
+        if (slot_of[child] != NO_SLOT) evict(child);
+
+    uint32_t slot = slot_of[page_id];
+    slot_of[page_id] = NO_SLOT;
+    page_in[slot] = NO_SLOT;
+    free_slots.push_back(slot);
+    ++counters.evicted;
+
+    uint32_t parent = file.info(page_id).parent;
+    if ((parent == PageFile::NO_PAGE) || (slot_of[parent] != NO_SLOT))
+        link(page_id, NO_SLOT);
+}
+
+/* Evicts the least recently used page not used in the last few frames (as *
+ * given by age), picking the page loaded deepest in the tree on ties (these *
+ * having the highest page IDs), so as to leave its ancestors. Returns false *
+ * if there is none.                                                         */
+bool PagedGeometry::reclaim(cl_uint age)
+{
+    uint32_t victim = NO_SLOT;
+
+    for (uint32_t slot = 0; slot < page_in.size(); ++slot)
+    {
+        if ((page_in[slot] == NO_SLOT) || (stamps[slot] + age >= header.frame))
+            continue;
+
+        if ((victim == NO_SLOT) || (stamps[slot] < stamps[victim])
+         || ((stamps[slot] == stamps[victim])
+          && (page_in[slot] > page_in[victim])))
+            victim = slot;
+    }
+
+    if (victim == NO_SLOT) return false;
+    evict(page_in[victim]);
+    return true;
+}
+
+std::size_t PagedGeometry::update(const std::vector<uint32_t> &chunks)
+{
+    scheduler::read(mem, 0, sizeof(header), &header, true);
+    scheduler::read(mem, node_offset(header.slots, 0),
+                    stamps.size() * sizeof(cl_uint), stamps.data(), true);
+
+    for (std::size_t slot = 0; slot < page_in.size(); ++slot)
+        if ((page_in[slot] != NO_SLOT) && (stamps[slot] == header.frame))
+            ++counters.hits;
+
+    ++header.frame; // the frame just rendered is now the last frame
+    std::size_t loaded = 0;
+
+    for (uint32_t chunk : chunks)
+    {
+        /* Chunks in view are kept resident, even if occluded for now. */
+        if (slot_of[chunk] != NO_SLOT)
+        {
+            stamps[slot_of[chunk]] = header.frame;
+            continue;
+        }
+
+        ++counters.misses;
+        if (free_slots.empty() && !reclaim(1)) break;
+
+        place(chunk);
+        ++loaded;
+    }
+
+    for (cl_uint request : header.request)
+    {
+        if (request == 0) continue;
+        uint32_t page_id = request - 1;
+
+        /* Requests may be stale (issued before the page was linked in). */
+        if ((page_id >= slot_of.size()) || (slot_of[page_id] != NO_SLOT))
+            continue;
+
+        /* The parent can have been evicted to make room for another page. */
+        uint32_t parent = file.info(page_id).parent;
+        if ((parent == PageFile::NO_PAGE) || (slot_of[parent] == NO_SLOT))
+            continue;
+
+        ++counters.misses;
+        if (free_slots.empty() && !reclaim(1)) break;
+
+        /* This may in turn have evicted the parent, see reclaim(). */
+        if (slot_of[file.info(page_id).parent] == NO_SLOT) continue;
+
+        place(page_id);
+        ++loaded;
+    }
+
+    flush();
+
+    std::fill(std::begin(header.request), std::end(header.request), 0);
+    scheduler::write(mem, 0, sizeof(header), &header, true);
+    return loaded;
+}
+
+std::size_t PagedGeometry::prefetch(const math::float3 &pos,
+                                    const math::float3 &dir, float fov,
+                                    float aspect)
+{
+    /* The cone must contain the corners of the (rectangular) view frustum. */
+    float half_angle = atan(tan(fov * 0.5f) * sqrt(1 + aspect * aspect));
+    std::vector<std::pair<float, uint32_t>> candidates;
+
+    for (uint32_t slot = 0; slot < page_in.size(); ++slot)
+    {
+        if (page_in[slot] == NO_SLOT) continue;
+
+        for (uint32_t child : children[page_in[slot]])
+        {
+            if (slot_of[child] != NO_SLOT) continue;
+
+            /* The page's cube, within the cube of the chunk it is in. */
+            const PageFile::PageInfo &info = file.info(child);
+            aabb chunk = grid.bounds(cell_of[info.tree]);
+            float size = ChunkGrid::CHUNK_SIZE / (float)(1u << info.level);
+            math::float3 center = chunk.min + math::float3(info.x + 0.5f,
+                                                           info.y + 0.5f,
+                                                           info.z + 0.5f)
+                                            * size;
+            float radius = 0.5f * sqrt(3.0f) * size;
+
+            math::float3 to_cube = center - pos;
+            float distance = math::length(to_cube);
+
+            if (distance > radius)
+            {
+                float angle = acos(std::max(-1.0f, std::min(1.0f,
+                              math::dot(to_cube, dir) / distance)));
+                if (angle - asin(radius / distance) > half_angle) continue;
+            }
+
+            candidates.emplace_back(distance - radius, child);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    std::size_t loaded = 0;
+
+    for (const auto &candidate : candidates)
+    {
+        if (loaded == MAX_PREFETCH) break;
+        if (free_slots.empty() && !reclaim(PREFETCH_AGE)) break;
+
+        /* The parent may have been evicted, see reclaim(). */
+        uint32_t page_id = candidate.second;
+        if (slot_of[file.info(page_id).parent] == NO_SLOT) continue;
+
+        place(page_id);
+        ++counters.prefetched;
+        ++loaded;
+    }
+
+    flush();
+    return loaded;
+}
+
+std::size_t PagedGeometry::resident(void) const
+{
+    return page_in.size() - free_slots.size();
+}
+
+const ChunkGrid &PagedGeometry::chunks(void) const
+{
+    return grid;
+}
+
+const PagedGeometry::Stats &PagedGeometry::stats(void) const
+{
+    return counters;
+}
+
+void PagedGeometry::notify_cb(std::map<std::string, cl::Kernel> &kernels)
+{
+    scheduler::set_arg(kernels["render"], "geometry", mem);
+}
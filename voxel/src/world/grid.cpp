@@ -0,0 +1,93 @@
+#include "world/grid.hpp"
+#include "world/observer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+const float ChunkGrid::CHUNK_SIZE = 2;
+const uint32_t ChunkGrid::NO_CHUNK;
+
+ChunkGrid::ChunkGrid(uint32_t width, uint32_t height, uint32_t depth)
+    : size{width, height, depth}, chunks(width * height * depth, NO_CHUNK)
+{
+    if (chunks.empty()) throw std::logic_error("Chunk grid is empty");
+}
+
+uint32_t ChunkGrid::width(void) const
+{
+    return size[0];
+}
+
+uint32_t ChunkGrid::height(void) const
+{
+    return size[1];
+}
+
+uint32_t ChunkGrid::depth(void) const
+{
+    return size[2];
+}
+
+std::size_t ChunkGrid::cells(void) const
+{
+    return chunks.size();
+}
+
+uint32_t ChunkGrid::cell(uint32_t x, uint32_t y, uint32_t z) const
+{
+    return (z * size[1] + y) * size[0] + x;
+}
+
+aabb ChunkGrid::bounds(uint32_t cell) const
+{
+    math::float3 pos((float)(cell % size[0]),
+                     (float)(cell / size[0] % size[1]),
+                     (float)(cell / size[0] / size[1]));
+    math::float3 extent((float)size[0], (float)size[1], (float)size[2]);
+
+    math::float3 min = (pos - extent * 0.5f) * CHUNK_SIZE;
+    return aabb{min, min + math::float3(CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE)};
+}
+
+void ChunkGrid::set_chunk(uint32_t cell, uint32_t chunk)
+{
+    chunks.at(cell) = chunk;
+}
+
+uint32_t ChunkGrid::chunk(uint32_t cell) const
+{
+    return chunks.at(cell);
+}
+
+/* Returns the distance from a point to a box (zero if it is inside). */
+static float distance(const math::float3 &p, const aabb &box)
+{
+    math::float3 d(std::max(std::max(box.min.x - p.x, p.x - box.max.x), 0.0f),
+                   std::max(std::max(box.min.y - p.y, p.y - box.max.y), 0.0f),
+                   std::max(std::max(box.min.z - p.z, p.z - box.max.z), 0.0f));
+    return math::length(d);
+}
+
+std::vector<uint32_t> ChunkGrid::visible(const Observer &observer,
+                                         float aspect) const
+{
+    std::vector<std::pair<float, uint32_t>> found;
+
+    for (uint32_t cell = 0; cell < chunks.size(); ++cell)
+    {
+        if (chunks[cell] == NO_CHUNK) continue;
+
+        aabb box = bounds(cell);
+        float d = distance(observer.position(), box);
+
+        if ((d < CHUNK_SIZE) || observer.in_view(box, aspect))
+            found.emplace_back(d, chunks[cell]);
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<uint32_t> result;
+    for (const auto &chunk : found) result.push_back(chunk.second);
+    return result;
+}
@@ -0,0 +1,79 @@
+#include "world/materials.hpp"
+
+#include "setup/scheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+static cl_uint pack_unorm8(const math::float3 &c)
+{
+    auto unorm8 = [](float x) -> cl_uint
+    {
+        return (cl_uint)(std::min(std::max(x, 0.0f), 1.0f) * 255 + 0.5f);
+    };
+
+    return unorm8(c.x) | (unorm8(c.y) << 8) | (unorm8(c.z) << 16);
+}
+
+/* This is the shared exponent format of EXT_texture_shared_exponent, having *
+ * a 9-bit mantissa per channel and a 5-bit exponent with a bias of 15.      */
+static cl_uint pack_rgb9e5(const math::float3 &c)
+{
+    const float max_value = 65408; // (511 / 512) * 2^16
+
+    float r = std::min(std::max(c.x, 0.0f), max_value);
+    float g = std::min(std::max(c.y, 0.0f), max_value);
+    float b = std::min(std::max(c.z, 0.0f), max_value);
+    float m = std::max(std::max(r, g), b);
+    if (m == 0) return 0;
+
+    int e = std::max(-16, (int)std::floor(std::log2(m))) + 16;
+    float scale = std::ldexp(1.0f, e - 24);
+
+    if ((cl_uint)(m / scale + 0.5f) == 512) // rounded up to the next exponent
+        scale = std::ldexp(1.0f, ++e - 24);
+
+    return (cl_uint)(r / scale + 0.5f)
+         | ((cl_uint)(g / scale + 0.5f) << 9)
+         | ((cl_uint)(b / scale + 0.5f) << 18)
+         | ((cl_uint)e << 27);
+}
+
+MaterialDB::MaterialDB()
+{
+    mem = scheduler::alloc_buffer(sizeof(Header) + MAX_MATERIALS
+                                * sizeof(cl_uint2), CL_MEM_READ_ONLY);
+
+    table.resize(1);
+    set(0, math::float3(0.7f, 0.7f, 0.7f));
+}
+
+void MaterialDB::set(uint16_t id, const math::float3 &albedo,
+                     const math::float3 &emission)
+{
+    if (id >= MAX_MATERIALS)
+        throw std::out_of_range("Material ID exceeds the table size");
+
+    if (id >= table.size()) table.resize(id + 1, table[0]);
+    table[id].s[0] = pack_unorm8(albedo);
+    table[id].s[1] = pack_rgb9e5(emission);
+}
+
+std::size_t MaterialDB::size(void) const
+{
+    return table.size();
+}
+
+void MaterialDB::upload(void)
+{
+    Header header{(cl_uint)table.size(), 0};
+    scheduler::write(mem, 0, sizeof(header), &header, true);
+    scheduler::write(mem, sizeof(header), table.size() * sizeof(cl_uint2),
+                     table.data(), true);
+}
+
+void MaterialDB::notify_cb(std::map<std::string, cl::Kernel> &kernels)
+{
+    scheduler::set_arg(kernels["render"], "mtl_table", mem);
+}
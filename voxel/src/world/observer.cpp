@@ -104,6 +104,50 @@ void Observer::set_fov(float fov)
     update();
 }
 
+const math::float3 &Observer::position(void) const
+{
+    return data.pos;
+}
+
+const math::float3 &Observer::direction(void) const
+{
+    return data.dir;
+}
+
+float Observer::fov(void) const
+{
+    return data.fov;
+}
+
+bool Observer::in_view(const aabb &box, float aspect) const
+{
+    float3 up(-sin(data.roll), cos(data.roll), 0);
+    float3x3 view = basis2(data.dir, up);
+    float z = 1.0f / tan(data.fov * 0.5f);
+
+    /* As in the perspective projection, which widens the focal plane. */
+    float3 corner[4] = {view * float3(-aspect, +1.0f, z),
+                        view * float3(+aspect, +1.0f, z),
+                        view * float3(+aspect, -1.0f, z),
+                        view * float3(-aspect, -1.0f, z)};
+
+    /* The box is outside if it is entirely behind any of the side planes, *
+     * that is, if its corner furthest along the inward normal is behind. */
+    for (size_t t = 0; t < 4; ++t)
+    {
+        float3 n = cross(corner[t], corner[(t + 1) % 4]);
+        if (dot(n, data.dir) < 0) n = -n;
+
+        float3 p(n.x >= 0 ? box.max.x : box.min.x,
+                 n.y >= 0 ? box.max.y : box.min.y,
+                 n.z >= 0 ? box.max.z : box.min.z);
+
+        if (dot(n, p - data.pos) < 0) return false;
+    }
+
+    return true;
+}
+
 void Observer::notify_cb(std::map<std::string, cl::Kernel> &kernels)
 {
     scheduler::set_arg(kernels["render"], "observer", mem);
@@ -0,0 +1,41 @@
+#include "world/trajectory.hpp"
+
+/* The weight of the latest frame's motion in the smoothed motion, and below *
+ * which motion (per frame) is considered to have stopped.                  */
+static const float SMOOTHING = 0.3f;
+static const float MIN_SPEED = 1e-5f, MIN_TURN = 1e-4f;
+
+Trajectory::Trajectory()
+    : recorded(false)
+{
+
+}
+
+void Trajectory::record(const math::float3 &pos, const math::float3 &dir)
+{
+    if (recorded)
+    {
+        velocity = velocity * (1 - SMOOTHING) + (pos - this->pos) * SMOOTHING;
+        turn = turn * (1 - SMOOTHING) + (dir - this->dir) * SMOOTHING;
+    }
+
+    this->pos = pos;
+    this->dir = dir;
+    recorded = true;
+}
+
+bool Trajectory::moving(void) const
+{
+    return (math::length(velocity) > MIN_SPEED)
+        || (math::length(turn) > MIN_TURN);
+}
+
+math::float3 Trajectory::position(float frames) const
+{
+    return pos + velocity * frames;
+}
+
+math::float3 Trajectory::direction(float frames) const
+{
+    return math::normalize(dir + turn * frames);
+}
@@ -1,22 +1,102 @@
 #include "world/world.hpp"
 
-#include "setup/scheduler.hpp"
+#include "geometry/generator.hpp"
+#include "gui/log.hpp"
 
-World::World()
+#include <cmath>
+
+static const char *TEST_PAGES = "test_world.pages";
+
+/* The test world's terrain continues across a few chunks around the origin. */
+static const uint32_t TEST_GRID[3] = {3, 1, 3};
+static const uint32_t TEST_LEVELS = 7;
+
+/* The test world's terrain height, whose slope is at most 0.3 along x and *
+ * 0.45 along z.                                                          */
+static float test_height(float x, float z)
+{
+    return -0.9f + 0.03f * (std::sin(15 * z) + std::sin(10 * x + 1));
+}
+
+/* How far ahead to predict the observer's path for prefetching, in frames. */
+static const float LOOKAHEAD = 30;
+
+/* The most frames settle() renders, which is far more than the depth of any *
+ * tree in pages, so that only thrashing pages ever reach it.                */
+static const std::size_t MAX_SETTLE_FRAMES = 256;
+
+/* Pages the procedural test world (building the octree of each chunk in *
+ * turn), returning the path of its page file.                           */
+static std::string build_test_world(void)
+{
+    ChunkGrid grid(TEST_GRID[0], TEST_GRID[1], TEST_GRID[2]);
+    PageFile::Writer writer(TEST_PAGES, PagedGeometry::PAGE_NODES,
+                            grid.width(), grid.height(), grid.depth());
+    HeightfieldGenerator terrain(test_height, 0.3f, 0.45f, 0);
+
+    for (uint32_t cell = 0; cell < grid.cells(); ++cell)
+    {
+        std::vector<Node> nodes = terrain.build(grid.bounds(cell),
+                                                TEST_LEVELS);
+        if (!nodes.empty()) writer.add(cell, nodes, 0);
+    }
+
+    std::size_t pages = writer.finish();
+    print_info("Split test world into " + std::to_string(pages) + " pages");
+    return TEST_PAGES;
+}
+
+World::World(const std::string &path, std::size_t page_budget)
+    : geometry(path.empty() ? build_test_world() : path,
+               page_budget / PagedGeometry::page_size())
 {
     observer.move_to(math::float3(-0.15, -0.60, -0.20));
     observer.look_at(math::float3(0, -0.5, 1));
     observer.set_fov(90);
 
-    geometry = scheduler::alloc_buffer(geometry_o.bufSize(),
-                                 CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                                 geometry_o.getPtr());
+    materials.set(0, math::float3(0.62f, 0.58f, 0.50f)); // terrain
+    materials.upload();
 }
 
 void World::notify_cb(std::map<std::string, cl::Kernel> &kernels)
 {
-    scheduler::set_arg(kernels["render"], "geometry", geometry);
+    geometry.notify_cb(kernels);
     observer.notify_cb(kernels);
+    materials.notify_cb(kernels);
+}
+
+bool World::update(float aspect)
+{
+    trajectory.record(observer.position(), observer.direction());
+    std::size_t loaded = geometry.update(geometry.chunks().visible(observer,
+                                                                   aspect));
+
+    /* A stationary observer will have requested everything in view. */
+    if (trajectory.moving())
+        loaded += geometry.prefetch(trajectory.position(LOOKAHEAD),
+                                    trajectory.direction(LOOKAHEAD),
+                                    observer.fov(), aspect);
+
+    return loaded > 0;
+}
+
+bool World::settle(float aspect, const std::function<void(void)> &render)
+{
+    for (std::size_t frame = 0; frame < MAX_SETTLE_FRAMES; ++frame)
+    {
+        render();
+        if (!update(aspect)) return true;
+    }
+
+    print_error("Geometry did not settle after "
+              + std::to_string(MAX_SETTLE_FRAMES) + " frames (the page "
+              + "budget may be too small for the view)");
+    return false;
+}
+
+const PagedGeometry &World::pages(void) const
+{
+    return geometry;
 }
 
 void World::turn_h(const float amount)